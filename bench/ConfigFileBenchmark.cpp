@@ -0,0 +1,75 @@
+// Copyright 2012, Fredy Wijaya
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the Lesser GNU General Public License as published by
+// the Free Software Foundation, either version 3.0 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// Lesser GNU General Public License for more details.
+//
+// You should have received a copy of the Lesser GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>
+
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include "ArgumentParser.h"
+#include "ConfigFile.h"
+
+using namespace std;
+using namespace cppargparser;
+
+// measures reading a configuration file and merging it into the parsed
+// arguments for growing file sizes
+
+int main() {
+    const char* path = "cppargparser_config_benchmark.conf";
+    const int runs = 20;
+    printf("%10s %15s %15s\n", "lines", "read us/op", "parse us/op");
+    for (int lines = 100; lines <= 100000; lines *= 10) {
+        {
+            ofstream out(path);
+            for (int i = 0; i < lines; ++i) {
+                if (i % 100 == 0) {
+                    out << "# section " << i / 100 << "\n";
+                }
+                out << "option-" << i % 1000 << " = \"value " << i << "\"\n";
+            }
+        }
+        ArgumentParser argParser;
+        for (int i = 0; i < 1000; ++i) {
+            ostringstream oss;
+            oss << "--option-" << i;
+            argParser.addArgument(Argument(oss.str(), "option", Argument::LONG, 1, false));
+        }
+        argParser.addConfigFile(path);
+
+        size_t checksum = 0;
+        clock_t start = clock();
+        for (int i = 0; i < runs; ++i) {
+            ConfigFile file(path);
+            checksum += file.getEntries().size();
+        }
+        double read = static_cast<double>(clock() - start) * 1e6 / CLOCKS_PER_SEC / runs;
+
+        const char* cargv[] = { "benchmark" };
+        start = clock();
+        for (int i = 0; i < runs; ++i) {
+            ParsedArgument pa = argParser.parse(1, const_cast<char**>(cargv));
+            checksum += pa.hasArgument("--option-0");
+        }
+        double parse = static_cast<double>(clock() - start) * 1e6 / CLOCKS_PER_SEC / runs;
+
+        printf("%10d %15.1f %15.1f\n", lines, read, parse);
+        if (checksum == 42) {
+            printf("\n");
+        }
+    }
+    remove(path);
+    return 0;
+}
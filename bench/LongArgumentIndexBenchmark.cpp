@@ -0,0 +1,87 @@
+// Copyright 2012, Fredy Wijaya
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the Lesser GNU General Public License as published by
+// the Free Software Foundation, either version 3.0 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// Lesser GNU General Public License for more details.
+//
+// You should have received a copy of the Lesser GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>
+
+#include <cstdio>
+#include <ctime>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "LongArgumentIndex.h"
+
+using namespace std;
+using namespace cppargparser;
+
+// compares the radix trie against a linear scan over all the long argument
+// names for resolving unique prefixes
+
+namespace {
+
+int naiveFind(const vector<string>& names, const string& prefix) {
+    int found = LongArgumentIndex::NOT_FOUND;
+    for (size_t i = 0; i < names.size(); ++i) {
+        if (names[i].compare(0, prefix.size(), prefix) == 0) {
+            if (names[i].size() == prefix.size()) {
+                return static_cast<int>(i);
+            }
+            found = (found == LongArgumentIndex::NOT_FOUND) ?
+                static_cast<int>(i) : LongArgumentIndex::AMBIGUOUS;
+        }
+    }
+    return found;
+}
+
+double elapsedNanos(clock_t start, size_t n) {
+    return static_cast<double>(clock() - start) * 1e9 / CLOCKS_PER_SEC / n;
+}
+
+}
+
+int main() {
+    const size_t lookups = 200000;
+    printf("%10s %15s %15s\n", "names", "trie ns/op", "scan ns/op");
+    for (size_t n = 10; n <= 10000; n *= 10) {
+        LongArgumentIndex index;
+        vector<string> names;
+        vector<string> prefixes;
+        for (size_t i = 0; i < n; ++i) {
+            ostringstream oss;
+            oss << "--option-" << i << "-name";
+            names.push_back(oss.str());
+            index.add(oss.str(), static_cast<int>(i));
+            prefixes.push_back(oss.str().substr(0, oss.str().size() - 3));
+        }
+
+        long checksum = 0;
+        clock_t start = clock();
+        for (size_t i = 0; i < lookups; ++i) {
+            checksum += index.find(prefixes[i % n]);
+        }
+        double trie = elapsedNanos(start, lookups);
+
+        // the linear scan is much slower, so use fewer lookups for it
+        size_t scanLookups = lookups / n + 1000;
+        start = clock();
+        for (size_t i = 0; i < scanLookups; ++i) {
+            checksum += naiveFind(names, prefixes[i % n]);
+        }
+        double scan = elapsedNanos(start, scanLookups);
+
+        printf("%10lu %15.1f %15.1f\n", static_cast<unsigned long>(n), trie, scan);
+        if (checksum == 42) {
+            printf("\n");
+        }
+    }
+    return 0;
+}
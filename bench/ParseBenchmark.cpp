@@ -0,0 +1,81 @@
+// Copyright 2012, Fredy Wijaya
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the Lesser GNU General Public License as published by
+// the Free Software Foundation, either version 3.0 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// Lesser GNU General Public License for more details.
+//
+// You should have received a copy of the Lesser GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>
+
+#include <cstdio>
+#include <ctime>
+#include <memory_resource>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "CppArgParser.h"
+
+using namespace std;
+using namespace cppargparser;
+
+// measures a whole parse of a typical command line, build it with
+// -DCPPARGPARSER_IMPLEMENTATION to compare the single translation unit
+// build against the library
+
+namespace {
+
+double elapsedNanos(clock_t start, size_t n) {
+    return static_cast<double>(clock() - start) * 1e9 / CLOCKS_PER_SEC / n;
+}
+
+}
+
+int main() {
+    const size_t parses = 200000;
+    ArgumentParser argParser;
+    for (int i = 0; i < 20; ++i) {
+        ostringstream oss;
+        oss << "--option-" << i;
+        argParser.addArgument(Argument("", oss.str(), "option", 1, false));
+    }
+    argParser.addArgument(Argument("-v", "--verbose", "verbose", 0, false)
+        .setDuplicatePolicy(Argument::FIRST_WINS));
+    argParser.addArgument(Argument("-o", "--output", "output", 1, true));
+    argParser.addArgument(Argument("files", "files", Argument::POSITIONAL,
+        Argument::INFINITY, false));
+
+    const char* cargv[] = {
+        "program", "-vv", "--option-3", "3", "--option-12=12", "-o", "out.txt",
+        "--option-19", "19", "a.txt", "b.txt", "c.txt"
+    };
+    int argc = static_cast<int>(sizeof(cargv) / sizeof(cargv[0]));
+    char** argv = const_cast<char**>(cargv);
+
+    long checksum = 0;
+    char buffer[16384];
+    clock_t start = clock();
+    for (size_t i = 0; i < parses; ++i) {
+        pmr::monotonic_buffer_resource resource(buffer, sizeof(buffer));
+        ParsedArgument pa = argParser.parse(argc, argv, &resource);
+        checksum += pa.getCount("-v") + pa.getValues("files").size();
+    }
+    double parse = elapsedNanos(start, parses);
+
+#ifdef CPPARGPARSER_IMPLEMENTATION
+    const char* build = "single translation unit";
+#else
+    const char* build = "library";
+#endif
+    printf("%-25s %15s\n", "build", "ns/parse");
+    printf("%-25s %15.1f\n", build, parse);
+    if (checksum == 42) {
+        printf("\n");
+    }
+    return 0;
+}
@@ -0,0 +1,78 @@
+// Copyright 2012, Fredy Wijaya
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the Lesser GNU General Public License as published by
+// the Free Software Foundation, either version 3.0 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// Lesser GNU General Public License for more details.
+//
+// You should have received a copy of the Lesser GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>
+
+#include <cstdio>
+#include <ctime>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "PatternValidator.h"
+
+using namespace std;
+using namespace cppargparser;
+
+// compares the precompiled DFA against std::regex compiled once and against
+// std::regex compiled for every value, as a validator written by hand would
+
+namespace {
+
+double elapsedNanos(clock_t start, size_t n) {
+    return static_cast<double>(clock() - start) * 1e9 / CLOCKS_PER_SEC / n;
+}
+
+}
+
+int main() {
+    const size_t matches = 200000;
+    const char* pattern = "[a-z0-9.-]+:\\d{1,5}";
+    vector<string> values;
+    for (size_t i = 0; i < 100; ++i) {
+        ostringstream oss;
+        oss << "host-" << i << ".example.com:" << (i * 97 % 65536);
+        values.push_back(oss.str());
+    }
+    values.push_back("not a host");
+
+    long checksum = 0;
+    clock_t start = clock();
+    PatternValidator validator(pattern);
+    for (size_t i = 0; i < matches; ++i) {
+        checksum += validator.matches(values[i % values.size()]);
+    }
+    double dfa = elapsedNanos(start, matches);
+
+    start = clock();
+    regex re(pattern);
+    for (size_t i = 0; i < matches; ++i) {
+        checksum += regex_match(values[i % values.size()], re);
+    }
+    double compiledRegex = elapsedNanos(start, matches);
+
+    // compiling for every value is much slower, so use fewer matches for it
+    size_t regexMatches = matches / 20;
+    start = clock();
+    for (size_t i = 0; i < regexMatches; ++i) {
+        checksum += regex_match(values[i % values.size()], regex(pattern));
+    }
+    double uncompiledRegex = elapsedNanos(start, regexMatches);
+
+    printf("%15s %20s %20s\n", "dfa ns/op", "std::regex ns/op", "per-call ns/op");
+    printf("%15.1f %20.1f %20.1f\n", dfa, compiledRegex, uncompiledRegex);
+    if (checksum == 42) {
+        printf("\n");
+    }
+    return 0;
+}
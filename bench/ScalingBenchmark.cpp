@@ -0,0 +1,203 @@
+// Copyright 2012, Fredy Wijaya
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the Lesser GNU General Public License as published by
+// the Free Software Foundation, either version 3.0 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// Lesser GNU General Public License for more details.
+//
+// You should have received a copy of the Lesser GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>
+
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <memory_resource>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "CppArgParser.h"
+
+using namespace std;
+using namespace cppargparser;
+
+// measures how the parse time scales with the number of arguments in the
+// schema, the number of tokens, the mix of short, long and --name=value
+// tokens and the number of values of each argument. The results are printed
+// as CSV. By default each factor is varied on its own around a baseline of
+// 100 arguments and 10000 tokens of all kinds, --full runs every
+// combination instead.
+
+namespace {
+
+enum Mix { SHORT_MIX, LONG_MIX, EQUALS_MIX, ALL_MIX };
+enum Arity { FLAGS, ONE, TWO, VARIADIC, ALL_ARITIES };
+
+const char* const MIX_NAMES[] = { "short", "long", "equals", "all" };
+const char* const ARITY_NAMES[] = { "flags", "one", "two", "variadic", "all" };
+const char SHORT_NAMES[] =
+    "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+const size_t SHORT_COUNT = sizeof(SHORT_NAMES) - 1;
+// the number of values given to the arguments that take a variable number
+const int VARIADIC_VALUES = 3;
+
+struct Config {
+    size_t schema;
+    size_t tokens;
+    Mix mix;
+    Arity arity;
+};
+
+int numArgs(Arity arity, size_t option) {
+    switch (arity == ALL_ARITIES ? static_cast<Arity>(option % 4) : arity) {
+    case FLAGS:
+        return 0;
+    case ONE:
+        return 1;
+    case TWO:
+        return 2;
+    default:
+        return Argument::INFINITY;
+    }
+}
+
+string longName(size_t option) {
+    ostringstream oss;
+    oss << "--option-" << option;
+    return oss.str();
+}
+
+void addArguments(ArgumentParser& argParser, const Config& config) {
+    for (size_t i = 0; i < config.schema; ++i) {
+        string shortName = "";
+        if (i < SHORT_COUNT) {
+            shortName = string("-") + SHORT_NAMES[i];
+        }
+        int n = numArgs(config.arity, i);
+        // the arguments are repeated in long command lines
+        argParser.addArgument(Argument(shortName, longName(i), "option", n, false)
+            .setDuplicatePolicy(n == 0 ? Argument::FIRST_WINS : Argument::APPEND));
+    }
+}
+
+// generates about config.tokens tokens, an argument is never cut from its
+// values so there can be a few more
+vector<string> generateTokens(const Config& config) {
+    vector<string> tokens;
+    tokens.reserve(config.tokens + VARIADIC_VALUES + 1);
+    for (size_t i = 0; tokens.size() < config.tokens; ++i) {
+        Mix mix = (config.mix == ALL_MIX) ? static_cast<Mix>(i % 3) : config.mix;
+        // spread the arguments over the whole schema, the short tokens only
+        // use the arguments with a short name
+        size_t options = (mix == SHORT_MIX && config.schema > SHORT_COUNT) ?
+            SHORT_COUNT : config.schema;
+        size_t option = (i * 7919) % options;
+        int n = numArgs(config.arity, option);
+        int values = (n == Argument::INFINITY) ? VARIADIC_VALUES : n;
+        ostringstream value;
+        value << "value" << i;
+        if (mix == SHORT_MIX && option < SHORT_COUNT) {
+            tokens.push_back(string("-") + SHORT_NAMES[option]);
+        } else if (mix == EQUALS_MIX && values > 0) {
+            tokens.push_back(longName(option) + "=" + value.str());
+            --values;
+        } else {
+            tokens.push_back(longName(option));
+        }
+        for (int k = 0; k < values; ++k) {
+            tokens.push_back(value.str());
+        }
+    }
+    return tokens;
+}
+
+double elapsedNanos(clock_t start, size_t n) {
+    return static_cast<double>(clock() - start) * 1e9 / CLOCKS_PER_SEC / n;
+}
+
+void run(const Config& config) {
+    ArgumentParser argParser;
+    addArguments(argParser, config);
+    vector<string> tokens = generateTokens(config);
+    vector<char*> argv;
+    argv.reserve(tokens.size() + 1);
+    argv.push_back(const_cast<char*>("program"));
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        argv.push_back(&tokens[i][0]);
+    }
+    int argc = static_cast<int>(argv.size());
+
+    // parse for at least 50 ms so that the short command lines are timed
+    // over many parses
+    size_t parses = 0;
+    long checksum = 0;
+    clock_t start = clock();
+    do {
+        pmr::monotonic_buffer_resource resource;
+        ParsedArgument pa = argParser.parse(argc, &argv[0], &resource);
+        checksum += pa.hasArgument("--option-0");
+        ++parses;
+    } while (clock() - start < CLOCKS_PER_SEC / 20);
+    double parse = elapsedNanos(start, parses);
+
+    printf("%lu,%lu,%s,%s,%lu,%.1f,%.2f\n",
+        static_cast<unsigned long>(config.schema),
+        static_cast<unsigned long>(tokens.size()), MIX_NAMES[config.mix],
+        ARITY_NAMES[config.arity], static_cast<unsigned long>(parses), parse,
+        parse / tokens.size());
+    if (checksum == 42) {
+        printf("\n");
+    }
+}
+
+}
+
+int main(int argc, char** argv) {
+    bool full = argc > 1 && strcmp(argv[1], "--full") == 0;
+    const size_t schemas[] = { 1, 10, 100, 1000, 10000 };
+    const size_t tokens[] = { 1, 10, 100, 1000, 10000, 100000, 1000000 };
+    const size_t schemaCount = sizeof(schemas) / sizeof(schemas[0]);
+    const size_t tokenCount = sizeof(tokens) / sizeof(tokens[0]);
+    const Config baseline = { 100, 10000, ALL_MIX, ALL_ARITIES };
+
+    printf("schema,tokens,mix,arity,parses,ns_per_parse,ns_per_token\n");
+    if (full) {
+        for (size_t s = 0; s < schemaCount; ++s) {
+            for (size_t t = 0; t < tokenCount; ++t) {
+                for (int m = SHORT_MIX; m <= ALL_MIX; ++m) {
+                    for (int a = FLAGS; a <= ALL_ARITIES; ++a) {
+                        Config config = { schemas[s], tokens[t],
+                            static_cast<Mix>(m), static_cast<Arity>(a) };
+                        run(config);
+                    }
+                }
+            }
+        }
+        return 0;
+    }
+    for (size_t t = 0; t < tokenCount; ++t) {
+        Config config = baseline;
+        config.tokens = tokens[t];
+        run(config);
+    }
+    for (size_t s = 0; s < schemaCount; ++s) {
+        Config config = baseline;
+        config.schema = schemas[s];
+        run(config);
+    }
+    for (int m = SHORT_MIX; m <= ALL_MIX; ++m) {
+        Config config = baseline;
+        config.mix = static_cast<Mix>(m);
+        run(config);
+    }
+    for (int a = FLAGS; a <= ALL_ARITIES; ++a) {
+        Config config = baseline;
+        config.arity = static_cast<Arity>(a);
+        run(config);
+    }
+    return 0;
+}
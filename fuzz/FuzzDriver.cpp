@@ -0,0 +1,357 @@
+// Copyright 2012, Fredy Wijaya
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the Lesser GNU General Public License as published by
+// the Free Software Foundation, either version 3.0 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// Lesser GNU General Public License for more details.
+//
+// You should have received a copy of the Lesser GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+#if defined(__SANITIZE_ADDRESS__)
+#include <sanitizer/common_interface_defs.h>
+#endif
+
+using namespace std;
+
+// a standalone driver for the fuzz targets, for the compilers without
+// libFuzzer and for AFL. It runs the inputs given as files or directories
+// (or the standard input if there are none), optionally mutates them and
+// reports the executions per second and the slowest inputs. The input that
+// crashes is written to crash-input.
+//
+// Usage: ParseFuzzer [-runs=N] [-seed=N] [-max_len=N] [-slowest=N]
+//                    [-scale=N] [-max_ratio=R] [files or directories]
+//
+// -runs     the number of mutated inputs to run after the given ones
+// -slowest  the number of the slowest inputs to report
+// -scale    also runs each given input with its tokens repeated N times and
+//           reports how much slower than N times the original it is, a
+//           ratio well above 1 means parse isn't linear in the tokens
+// -max_ratio fails if a scaled input is more than R times slower
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+namespace {
+
+typedef vector<uint8_t> Input;
+typedef chrono::steady_clock Clock;
+
+struct Timing {
+    double nanos;
+    size_t size;
+    string name;
+    Input input;
+};
+
+struct Scaling {
+    double ratio;
+    double nanos;
+    double scaledNanos;
+    string name;
+};
+
+const Input* currentInput = 0;
+const char CRASH_FILE[] = "crash-input";
+
+void writeCrashInput() {
+    if (currentInput == 0) {
+        return;
+    }
+    // only async-signal-safe calls here
+    int fd = open(CRASH_FILE, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd >= 0) {
+        ssize_t written = write(fd, currentInput->data(), currentInput->size());
+        (void) written;
+        close(fd);
+    }
+    const char message[] = "the crashing input is written to crash-input\n";
+    ssize_t written = write(STDERR_FILENO, message, sizeof(message) - 1);
+    (void) written;
+    currentInput = 0;
+}
+
+void onSignal(int sig) {
+    writeCrashInput();
+    signal(sig, SIG_DFL);
+    raise(sig);
+}
+
+void onTerminate() {
+    writeCrashInput();
+    abort();
+}
+
+double run(const Input& input) {
+    currentInput = &input;
+    Clock::time_point start = Clock::now();
+    LLVMFuzzerTestOneInput(input.data(), input.size());
+    Clock::time_point end = Clock::now();
+    currentInput = 0;
+    return static_cast<double>(
+        chrono::duration_cast<chrono::nanoseconds>(end - start).count());
+}
+
+// the average time of an input run for at least 10 ms
+double measure(const Input& input) {
+    double total = 0;
+    size_t n = 0;
+    while (total < 1e7) {
+        total += run(input);
+        ++n;
+    }
+    return total / n;
+}
+
+void readInputs(const string& path, vector<Input>& inputs, vector<string>& names) {
+    if (filesystem::is_directory(path)) {
+        vector<string> files;
+        for (const filesystem::directory_entry& entry :
+            filesystem::directory_iterator(path)) {
+            if (entry.is_regular_file()) {
+                files.push_back(entry.path().string());
+            }
+        }
+        sort(files.begin(), files.end());
+        for (vector<string>::const_iterator i = files.begin(); i != files.end(); ++i) {
+            readInputs(*i, inputs, names);
+        }
+        return;
+    }
+    ifstream in(path.c_str(), ios::binary);
+    if (!in) {
+        cerr << "can't read " << path << endl;
+        exit(1);
+    }
+    inputs.push_back(Input((istreambuf_iterator<char>(in)), istreambuf_iterator<char>()));
+    names.push_back(path);
+}
+
+const char* const DICTIONARY[] = {
+    "\n", "-", "--", "=", "-v", "--verbose", "-o", "--output", "-p", "--pair",
+    "-l", "--list", "-r", "--range", "-n", "--name", "-x", "--extract", "build",
+    "-t", "--target", "-j", "\n\n", " * ", " 1 ", " 2 "
+};
+
+void mutate(Input& input, mt19937& random, size_t maxLen) {
+    size_t mutations = 1 + random() % 4;
+    for (size_t m = 0; m < mutations; ++m) {
+        size_t pos = input.empty() ? 0 : random() % (input.size() + 1);
+        switch (random() % 5) {
+        case 0:
+            if (pos < input.size()) {
+                input[pos] ^= static_cast<uint8_t>(1 << (random() % 8));
+            }
+            break;
+        case 1:
+            input.insert(input.begin() + pos, static_cast<uint8_t>(random()));
+            break;
+        case 2:
+            if (pos < input.size()) {
+                input.erase(input.begin() + pos,
+                    input.begin() + min(input.size(), pos + 1 + random() % 8));
+            }
+            break;
+        case 3: {
+            const char* word = DICTIONARY[random() % (sizeof(DICTIONARY) / sizeof(DICTIONARY[0]))];
+            input.insert(input.begin() + pos, word, word + strlen(word));
+            break;
+        }
+        default:
+            // duplicates a slice, which grows the repetitive inputs that
+            // expose the superlinear behaviors
+            if (!input.empty()) {
+                size_t from = random() % input.size();
+                size_t n = 1 + random() % min<size_t>(64, input.size() - from);
+                Input slice(input.begin() + from, input.begin() + from + n);
+                input.insert(input.begin() + pos, slice.begin(), slice.end());
+            }
+            break;
+        }
+    }
+    if (input.size() > maxLen) {
+        input.resize(maxLen);
+    }
+}
+
+// repeats the tokens of an input, see fuzz/ParseFuzzer.cpp for the format
+Input scale(const Input& input, size_t times) {
+    size_t body = min<size_t>(1, input.size());
+    if (!input.empty() && (input[0] & 2) != 0) {
+        const uint8_t separator[] = { '\n', '\n' };
+        Input::const_iterator i = search(input.begin() + 1, input.end(),
+            separator, separator + 2);
+        body = (i == input.end()) ? input.size() : (i - input.begin()) + 2;
+    }
+    Input scaled(input.begin(), input.begin() + body);
+    for (size_t t = 0; t < times; ++t) {
+        scaled.insert(scaled.end(), input.begin() + body, input.end());
+        if (scaled.size() > body && scaled.back() != '\n') {
+            scaled.push_back('\n');
+        }
+    }
+    return scaled;
+}
+
+string preview(const Input& input) {
+    string s;
+    for (size_t i = 0; i < input.size() && i < 48; ++i) {
+        char c = static_cast<char>(input[i]);
+        if (c == '\n') {
+            s += "\\n";
+        } else if (c >= 32 && c < 127) {
+            s += c;
+        } else {
+            char hex[5];
+            snprintf(hex, sizeof(hex), "\\x%02x", input[i]);
+            s += hex;
+        }
+    }
+    return (input.size() > 48) ? s + "..." : s;
+}
+
+bool slower(const Timing& a, const Timing& b) {
+    return a.nanos > b.nanos;
+}
+
+bool lessLinear(const Scaling& a, const Scaling& b) {
+    return a.ratio > b.ratio;
+}
+
+}
+
+int main(int argc, char** argv) {
+    size_t runs = 0;
+    unsigned long seed = 1;
+    size_t maxLen = 4096;
+    size_t slowest = 10;
+    size_t times = 0;
+    double maxRatio = 0;
+    vector<Input> inputs;
+    vector<string> names;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg.compare(0, 6, "-runs=") == 0) {
+            runs = strtoul(arg.c_str() + 6, 0, 10);
+        } else if (arg.compare(0, 6, "-seed=") == 0) {
+            seed = strtoul(arg.c_str() + 6, 0, 10);
+        } else if (arg.compare(0, 9, "-max_len=") == 0) {
+            maxLen = strtoul(arg.c_str() + 9, 0, 10);
+        } else if (arg.compare(0, 9, "-slowest=") == 0) {
+            slowest = strtoul(arg.c_str() + 9, 0, 10);
+        } else if (arg.compare(0, 7, "-scale=") == 0) {
+            times = strtoul(arg.c_str() + 7, 0, 10);
+        } else if (arg.compare(0, 11, "-max_ratio=") == 0) {
+            maxRatio = strtod(arg.c_str() + 11, 0);
+        } else {
+            readInputs(arg, inputs, names);
+        }
+    }
+    if (inputs.empty()) {
+        inputs.push_back(Input((istreambuf_iterator<char>(cin)), istreambuf_iterator<char>()));
+        names.push_back("stdin");
+    }
+
+    signal(SIGABRT, onSignal);
+    signal(SIGSEGV, onSignal);
+    set_terminate(onTerminate);
+#if defined(__SANITIZE_ADDRESS__)
+    __sanitizer_set_death_callback(writeCrashInput);
+#endif
+
+    vector<Timing> timings;
+    double total = 0;
+    mt19937 random(seed);
+    for (size_t i = 0; i < inputs.size() + runs; ++i) {
+        Timing timing;
+        if (i < inputs.size()) {
+            timing.name = names[i];
+            timing.input = inputs[i];
+        } else {
+            size_t from = random() % inputs.size();
+            timing.name = "mutation of " + names[from];
+            timing.input = inputs[from];
+            mutate(timing.input, random, maxLen);
+        }
+        timing.nanos = run(timing.input);
+        timing.size = timing.input.size();
+        total += timing.nanos;
+        // only the slowest inputs are kept
+        timings.push_back(timing);
+        if (timings.size() > 4 * slowest + 16) {
+            nth_element(timings.begin(), timings.begin() + slowest, timings.end(), slower);
+            timings.resize(slowest);
+        }
+    }
+    // a single run can be slowed down by anything else on the machine, so
+    // the slowest inputs are timed again and keep their fastest run
+    for (vector<Timing>::iterator i = timings.begin(); i != timings.end(); ++i) {
+        for (int k = 0; k < 3; ++k) {
+            i->nanos = min(i->nanos, run(i->input));
+        }
+    }
+    sort(timings.begin(), timings.end(), slower);
+    if (timings.size() > slowest) {
+        timings.resize(slowest);
+    }
+
+    size_t executions = inputs.size() + runs;
+    printf("executions: %zu in %.3f s, %.0f exec/s\n", executions, total / 1e9,
+        executions / (total / 1e9));
+    printf("\nslowest inputs:\n");
+    printf("%12s %8s  %s\n", "ns", "bytes", "input");
+    for (vector<Timing>::const_iterator i = timings.begin(); i != timings.end(); ++i) {
+        printf("%12.0f %8zu  %s\n", i->nanos, i->size, i->name.c_str());
+        printf("%12s %8s  %s\n", "", "", preview(i->input).c_str());
+    }
+
+    if (times == 0) {
+        return 0;
+    }
+    vector<Scaling> scalings;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        Scaling scaling;
+        scaling.name = names[i];
+        scaling.nanos = measure(inputs[i]);
+        scaling.scaledNanos = measure(scale(inputs[i], times));
+        scaling.ratio = scaling.scaledNanos / (scaling.nanos * times);
+        scalings.push_back(scaling);
+    }
+    sort(scalings.begin(), scalings.end(), lessLinear);
+    printf("\nscaled %zu times:\n", times);
+    printf("%12s %12s %8s  %s\n", "ns", "scaled ns", "ratio", "input");
+    bool failed = false;
+    for (vector<Scaling>::const_iterator i = scalings.begin(); i != scalings.end(); ++i) {
+        printf("%12.0f %12.0f %8.2f  %s\n", i->nanos, i->scaledNanos, i->ratio,
+            i->name.c_str());
+        failed = failed || (maxRatio > 0 && i->ratio > maxRatio);
+    }
+    if (failed) {
+        printf("\nan input is more than %.2f times slower when scaled\n", maxRatio);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,205 @@
+// Copyright 2012, Fredy Wijaya
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the Lesser GNU General Public License as published by
+// the Free Software Foundation, either version 3.0 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// Lesser GNU General Public License for more details.
+//
+// You should have received a copy of the Lesser GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "CppArgParser.h"
+
+using namespace std;
+using namespace cppargparser;
+
+// the fuzz target for ArgumentParser::parse, ParsedArgument and the help
+// menu. It can be linked with libFuzzer (clang -fsanitize=fuzzer) or with
+// fuzz/FuzzDriver.cpp, which also runs the corpus for AFL and reports the
+// executions per second and the slowest inputs.
+//
+// The first byte of an input selects the mode: bit 0 allows abbreviations
+// and bit 1 declares the arguments from the input instead of the fixed
+// schema. The rest of the input is split into lines. In the declared mode
+// each line up to the first empty line is "<name> <arity> <description>",
+// where the name starts with -- for a long argument, with - for a short one
+// and with anything else for a positional one, and the arity is a digit or *
+// for a variable number of values. The remaining lines are the tokens
+// passed to parse.
+
+namespace {
+
+class BuildParserFactory : public ArgumentParserFactory {
+public:
+    ArgumentParser* create() const {
+        ArgumentParser* argParser = new ArgumentParser();
+        argParser->addArgument(Argument("-t", "--target", "target", 1, true));
+        argParser->addArgument(Argument("-j", "--jobs", "jobs", Argument::INFINITY, false)
+            .setNumArgs(0, 1));
+        return argParser;
+    }
+};
+
+const BuildParserFactory buildParserFactory;
+PatternValidator namePattern("[a-z][a-z0-9_]{0,15}");
+
+const char* const FIXED_NAMES[] = {
+    "-v", "--verbose", "-o", "--output", "-p", "--pair", "-l", "--list", "-r",
+    "--range", "-n", "--name", "-x", "--extract", "input", "files", "-t",
+    "--target", "-j", "--jobs", "--unknown"
+};
+
+unique_ptr<ArgumentParser> createFixedParser(bool abbreviation) {
+    unique_ptr<ArgumentParser> argParser(new ArgumentParser());
+    argParser->setAllowAbbreviation(abbreviation);
+    argParser->addArgument(Argument("-v", "--verbose", "verbose", 0, false)
+        .setDuplicatePolicy(Argument::FIRST_WINS));
+    argParser->addArgument(Argument("-o", "--output", "output", 1, false));
+    argParser->addArgument(Argument("-p", "--pair", "pair", 2, false)
+        .setDuplicatePolicy(Argument::LAST_WINS));
+    argParser->addArgument(Argument("-l", "--list", "list", Argument::INFINITY, false)
+        .setDuplicatePolicy(Argument::APPEND));
+    argParser->addArgument(Argument("-r", "--range", "range", Argument::INFINITY, false)
+        .setNumArgs(1, 3).setDuplicatePolicy(Argument::FIRST_WINS));
+    argParser->addArgument(Argument("-n", "--name", "name", 1, false, &namePattern));
+    argParser->addArgument(Argument("-x", "extract", Argument::SHORT, 0, false));
+    argParser->addArgument(Argument("--extract", "extract", Argument::LONG, 1, false));
+    argParser->addArgument(Argument("input", "input", Argument::POSITIONAL, 1, false));
+    argParser->addArgument(Argument("files", "files", Argument::POSITIONAL,
+        Argument::INFINITY, false).setNumArgs(0, 64));
+    argParser->addSubcommand("build", "build a target", &buildParserFactory);
+    argParser->addExcludes("--output", "--list");
+    argParser->addRequires("--pair", "--verbose");
+    return argParser;
+}
+
+vector<string> splitLines(const uint8_t* data, size_t size) {
+    vector<string> lines;
+    size_t begin = 0;
+    for (size_t i = 0; i <= size; ++i) {
+        if (i == size || data[i] == '\n') {
+            lines.push_back(string(reinterpret_cast<const char*>(data) + begin, i - begin));
+            begin = i + 1;
+        }
+    }
+    return lines;
+}
+
+// declares the arguments from the lines up to the first empty line and
+// returns the index of the first token
+size_t declareArguments(const vector<string>& lines, ArgumentParser& argParser,
+    vector<string>& names) {
+    size_t i = 0;
+    for (; i < lines.size() && !lines[i].empty(); ++i) {
+        const string& line = lines[i];
+        size_t space = line.find(' ');
+        string name = line.substr(0, space);
+        int numArgs = 0;
+        string desc;
+        if (space != string::npos && space + 1 < line.size()) {
+            char arity = line[space + 1];
+            numArgs = (arity == '*') ? Argument::INFINITY :
+                (arity >= '0' && arity <= '9') ? arity - '0' : 0;
+            if (space + 3 < line.size()) {
+                desc = line.substr(space + 3);
+            }
+        }
+        Argument::Type type = (name.compare(0, 2, "--") == 0) ? Argument::LONG :
+            (name.compare(0, 1, "-") == 0) ? Argument::SHORT : Argument::POSITIONAL;
+        try {
+            argParser.addArgument(Argument(name, desc, type, numArgs, false)
+                .setDuplicatePolicy(static_cast<Argument::DuplicatePolicy>(
+                    i % (Argument::APPEND + 1))));
+            names.push_back(name);
+        } catch (const InvalidArgumentException&) {
+            // e.g. a positional argument after a variable number of values
+        }
+    }
+    return i + 1;
+}
+
+void checkParsedArgument(ParsedArgument& pa, const vector<string>& names) {
+    for (size_t i = 0; i < names.size(); ++i) {
+        if (!pa.hasArgument(names[i])) {
+            if (pa.getCount(names[i]) != 0) {
+                abort();
+            }
+            continue;
+        }
+        ValueList values = pa.getValues(names[i]);
+        if (!values.empty() && pa.getValue(names[i]) != string_view(values[0])) {
+            abort();
+        }
+        pa.getSource(names[i]);
+    }
+    ParsedArgument copy(pa);
+    for (size_t i = 0; i < names.size(); ++i) {
+        if (copy.hasArgument(names[i])) {
+            size_t n = copy.getValues(names[i]).size();
+            if (copy.takeValues(names[i]).size() != n) {
+                abort();
+            }
+        }
+    }
+    if (pa.hasSubcommand()) {
+        pa.getSubcommand();
+    }
+}
+
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    if (size == 0) {
+        return 0;
+    }
+    static unique_ptr<ArgumentParser> fixedParsers[2] = {
+        createFixedParser(false), createFixedParser(true)
+    };
+    bool abbreviation = (data[0] & 1) != 0;
+    bool declared = (data[0] & 2) != 0;
+    vector<string> lines = splitLines(data + 1, size - 1);
+
+    unique_ptr<ArgumentParser> declaredParser;
+    ArgumentParser* argParser = fixedParsers[abbreviation ? 1 : 0].get();
+    vector<string> names;
+    size_t first = 0;
+    if (declared) {
+        declaredParser.reset(new ArgumentParser());
+        declaredParser->setAllowAbbreviation(abbreviation);
+        first = declareArguments(lines, *declaredParser, names);
+        argParser = declaredParser.get();
+        // the help menu is cached, so it's only rendered for the declared
+        // parsers
+        const string& help = argParser->getHelp("fuzz");
+        if (help.compare(0, 11, "Usage: fuzz") != 0) {
+            abort();
+        }
+    } else {
+        names.assign(FIXED_NAMES, FIXED_NAMES + sizeof(FIXED_NAMES) / sizeof(FIXED_NAMES[0]));
+    }
+
+    vector<char*> argv;
+    argv.push_back(const_cast<char*>("fuzz"));
+    for (size_t i = first; i < lines.size(); ++i) {
+        argv.push_back(&lines[i][0]);
+    }
+    try {
+        ParsedArgument pa = argParser->parse(static_cast<int>(argv.size()), &argv[0]);
+        checkParsedArgument(pa, names);
+    } catch (const InvalidArgumentException&) {
+        // invalid command lines are expected
+    }
+    return 0;
+}
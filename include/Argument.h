@@ -16,16 +16,34 @@
 #ifndef ARGUMENT_H_
 #define ARGUMENT_H_
 
+#include <memory>
 #include <string>
 #include <vector>
+#include "Export.h"
 #include "Validator.h"
 
 namespace cppargparser {
 
-class Argument {
+class CPPARGPARSER_API Argument {
 public:
     static const int INFINITY = -1;
-    enum Type { SHORT, LONG };
+    /**
+     * The argument type. A POSITIONAL argument, e.g. the input files, takes
+     * the tokens that aren't options in the order the positional arguments
+     * are added. Only the last positional argument can take a variable
+     * number of values.
+     */
+    enum Type { SHORT, LONG, POSITIONAL };
+    /**
+     * What to do when an argument is given more than once.
+     * REJECT: throw an InvalidArgumentException (default)
+     * FIRST_WINS: keep the values of the first occurrence
+     * LAST_WINS: replace the values with the ones of the last occurrence
+     * APPEND: keep the values of all the occurrences
+     * The occurrences are counted with every policy, see
+     * ParsedArgument::getCount, e.g. FIRST_WINS for -v -v -v.
+     */
+    enum DuplicatePolicy { REJECT, FIRST_WINS, LAST_WINS, APPEND };
 
     /**
      * Creates a new instance of Argument.
@@ -47,7 +65,8 @@ public:
      * @param desc the description
      * @param numArgs the number of arguments, for infinity use Argument::INFINITY constant
      * @param mandatory true if a given argument is mandatory; false otherwise
-     * @param validator the validator
+     * @param validator the validator, it isn't owned by the argument and
+     *        must outlive it
      */
     Argument(const std::string& shortArg, const std::string& longArg,
         const std::string& desc, int numArgs, bool mandatory,
@@ -73,7 +92,8 @@ public:
      * @param type the argument type
      * @param numArgs the number of arguments, for infinity use Argument::INFINITY constant
      * @param mandatory true if a given argument is mandatory; false otherwise
-     * @param validator the validator
+     * @param validator the validator, it isn't owned by the argument and
+     *        must outlive it
      */
     Argument(const std::string& arg, const std::string& desc, Type type,
         int numArgs, bool mandatory, Validator* validator);
@@ -82,19 +102,19 @@ public:
      * Gets the argument (short and then long).
      * @return the argument
      */
-    std::string getArg() const;
+    const std::string& getArg() const;
 
     /**
      * Gets the short argument.
      * @return the short argument
      */
-    std::string getShortArg() const;
+    const std::string& getShortArg() const;
 
     /**
-     * Gets the long argument.
+     * Gets the long argument, or the name of a positional argument.
      * @return the long argument
      */
-    std::string getLongArg() const;
+    const std::string& getLongArg() const;
 
     /**
      * Checks if the argument is a short argument.
@@ -108,11 +128,17 @@ public:
      */
     bool isLongArg() const;
 
+    /**
+     * Checks if the argument is a positional argument.
+     * @return true if the argument is a positional argument; false otherwise
+     */
+    bool isPositional() const;
+
     /**
      * Gets the argument description.
      * @return the argument description
      */
-    std::string getDescription() const;
+    const std::string& getDescription() const;
 
     /**
      * Gets the number of arguments.
@@ -120,6 +146,32 @@ public:
      */
     int getNumArgs() const;
 
+    /**
+     * Sets the minimum and the maximum number of arguments, e.g. 1 and
+     * Argument::INFINITY for one or more arguments. The number of arguments
+     * becomes Argument::INFINITY unless both are the same.
+     * @param minArgs the minimum number of arguments
+     * @param maxArgs the maximum number of arguments, for infinity use
+     *        Argument::INFINITY constant
+     * @return this argument
+     * @throw InvalidArgumentException if minArgs is negative or maxArgs is
+     *        less than minArgs
+     */
+    Argument& setNumArgs(int minArgs, int maxArgs);
+
+    /**
+     * Gets the minimum number of arguments.
+     * @return the minimum number of arguments
+     */
+    int getMinArgs() const;
+
+    /**
+     * Gets the maximum number of arguments.
+     * @return the maximum number of arguments, Argument::INFINITY if there's
+     *         no maximum
+     */
+    int getMaxArgs() const;
+
     /**
      * Checks if the argument is a mandatory.
      * @return true if it's mandatory; false otherwise
@@ -130,17 +182,47 @@ public:
      * Gets the validator.
      * @return the validator
      */
-    Validator* getValidator();
+    const Validator* getValidator() const;
+
+    /**
+     * Sets the validator. The validator is shared by all the copies of this
+     * argument and destroyed with the last of them, e.g.
+     * setValidator(std::make_shared<PatternValidator>("\\d+")).
+     * @param validator the validator
+     * @return this argument
+     */
+    Argument& setValidator(std::shared_ptr<const Validator> validator);
+
+    /**
+     * Sets what to do when the argument is given more than once.
+     * @param policy the duplicate policy
+     * @return this argument
+     */
+    Argument& setDuplicatePolicy(DuplicatePolicy policy);
+
+    /**
+     * Gets what to do when the argument is given more than once.
+     * @return the duplicate policy
+     */
+    DuplicatePolicy getDuplicatePolicy() const;
 
     virtual ~Argument();
 
 private:
+    // ArgumentParser interns the names and the description and shares the
+    // validator instead of keeping a copy of the argument
+    friend class ArgumentParser;
+
     std::string shortArg;
     std::string longArg;
     std::string description;
     int numArgs;
+    int minArgs;
+    int maxArgs;
     bool mandatory;
-    Validator* validator;
+    bool positional;
+    std::shared_ptr<const Validator> validator;
+    DuplicatePolicy duplicatePolicy;
 };
 
 } /* namespace cppargparser */
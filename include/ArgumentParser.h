@@ -16,22 +16,112 @@
 #ifndef ARGUMENTPARSER_H_
 #define ARGUMENTPARSER_H_
 
-#include <map>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
 #include <vector>
 #include <string>
+#include <string_view>
 #include "Argument.h"
+#include "ArgumentParserFactory.h"
+#include "Export.h"
+#include "LongArgumentIndex.h"
 #include "ParsedArgument.h"
+#include "StringPool.h"
 
 namespace cppargparser {
 
-class ArgumentParser {
+class CPPARGPARSER_API ArgumentParser {
 public:
     /**
-     * Adds an argument.
+     * Adds an argument. A positional argument must take values and can't be
+     * added after a positional argument that takes a variable number of
+     * values.
      * @param arg the argument
      */
     void addArgument(const Argument& arg);
 
+    /**
+     * Adds a subcommand, e.g. "build" in "program build --verbose". The
+     * subcommand parser is only created when the subcommand is selected
+     * and it parses all the arguments after the subcommand name.
+     * @param name the subcommand name
+     * @param desc the description
+     * @param factory the factory that creates the subcommand parser
+     */
+    void addSubcommand(const std::string& name, const std::string& desc,
+        const ArgumentParserFactory* factory);
+
+    /**
+     * Requires an argument to be given when another argument is given, e.g.
+     * -a requires -b. The arguments must already be added.
+     * @param arg the argument
+     * @param required the argument that must be given with arg
+     */
+    void addRequires(const std::string& arg, const std::string& required);
+
+    /**
+     * Forbids an argument to be given with another argument, e.g. --x
+     * excludes --y. The arguments must already be added.
+     * @param arg the argument
+     * @param excluded the argument that must not be given with arg
+     */
+    void addExcludes(const std::string& arg, const std::string& excluded);
+
+    /**
+     * Requires exactly one of the arguments to be given. The arguments must
+     * already be added.
+     * @param group the arguments
+     */
+    void addExactlyOne(const std::vector<std::string>& group);
+
+    /**
+     * Allows a long argument to be abbreviated by any of its unique prefixes,
+     * e.g. --verb for --verbose. An abbreviation that matches more than one
+     * long argument is rejected. Abbreviations are not allowed by default.
+     * @param allow true to allow abbreviations; false otherwise
+     */
+    void setAllowAbbreviation(bool allow);
+
+    /**
+     * Sets the prefix of the environment variables used for the arguments
+     * that aren't given in the command line. The environment variable name
+     * is the prefix followed by an underscore and the long argument name
+     * (or the short argument name if there's no long argument) in upper
+     * case, e.g. PREFIX_LOG_LEVEL for --log-level. The values of an argument
+     * that needs more than one value are separated by whitespaces. The
+     * environment is only read when a prefix is set.
+     * @param prefix the environment variable prefix
+     */
+    void setEnvironmentPrefix(const std::string& prefix);
+
+    /**
+     * Sets the number of threads that validate the arguments. With 0, the
+     * default, each argument is validated as soon as its values are parsed.
+     * Otherwise the validation is deferred until all the values are
+     * collected and the arguments are validated in parallel, so the
+     * validators must be thread-safe. All the invalid values are then
+     * reported in a single InvalidArgumentException, one per line in the
+     * order of the arguments in the command line. A validator exception of
+     * another type is rethrown as is if it's the only error, otherwise its
+     * message is reported with the others.
+     * @param threads the number of threads, including the calling thread
+     */
+    void setValidationThreads(unsigned int threads);
+
+    /**
+     * Adds a configuration file for the arguments that aren't given in the
+     * command line or in the environment. A file added later takes
+     * precedence over a file added earlier, e.g. add the system-wide file
+     * before the user file. A file that doesn't exist is ignored. See
+     * ConfigFile for the file format, the keys are the long argument names
+     * (or the short argument names if there's no long argument) without the
+     * leading dashes, e.g. log-level for --log-level. A flag is set by
+     * true/yes/on/1 and unset by false/no/off/0.
+     * @param path the file path
+     */
+    void addConfigFile(const std::string& path);
+
     /**
      * Parses the arguments.
      * @param argc the number of argument, the number of argument should
@@ -43,17 +133,124 @@ public:
      */
     ParsedArgument parse(int argc, char** argv);
 
+    /**
+     * Parses the arguments. All the memory needed while parsing and for the
+     * parsed argument is allocated from the given memory resource, e.g. a
+     * std::pmr::monotonic_buffer_resource on the stack.
+     * @param argc the number of argument including the program name
+     * @param argv the arguments
+     * @param resource the memory resource
+     * @return the parsed argument
+     */
+    ParsedArgument parse(int argc, char** argv, std::pmr::memory_resource* resource);
+
     /**
      * Shows/prints a default help menu. Override this show your custom help.
      * @param programName the program name
      */
     virtual void showHelp(const std::string& programName) const;
 
+    /**
+     * Gets the default help menu. The help menu is rendered once and cached
+     * until a new argument is added or a different program name is given.
+     * @param programName the program name
+     * @return the help menu
+     */
+    const std::string& getHelp(const std::string& programName) const;
+
+    ArgumentParser();
+
     virtual ~ArgumentParser();
 
 protected:
-    std::map<std::string, Argument> args;
-    std::vector<Argument> vargs;
+    // the name and the description are ids in strings
+    struct Subcommand {
+        uint32_t name;
+        uint32_t description;
+        const ArgumentParserFactory* factory;
+    };
+
+    // an added argument, the names and the description are ids in strings
+    // so that each of them is stored once and an Argument isn't kept
+    struct StoredArgument {
+        uint32_t shortArg;
+        uint32_t longArg;
+        uint32_t description;
+        int numArgs;
+        int minArgs;
+        int maxArgs;
+        bool mandatory;
+        bool positional;
+        Argument::DuplicatePolicy duplicatePolicy;
+        std::shared_ptr<const Validator> validator;
+    };
+
+    // a constraint on the seen arguments, the masks have a bit for each
+    // index in vargs
+    struct Constraint {
+        enum Type { REQUIRES, EXCLUDES, EXACTLY_ONE };
+        Type type;
+        // the argument that REQUIRES or EXCLUDES the arguments in mask
+        int id;
+        std::vector<uint64_t> mask;
+    };
+
+    // the argument and subcommand names and descriptions, each stored once
+    StringPool strings;
+    // maps the ids in strings of the short and long argument names to their
+    // indexes in vargs, NO_ARGUMENT for the other strings
+    std::vector<int> args;
+    std::vector<StoredArgument> vargs;
+    // maps the single character short arguments to their indexes in vargs
+    int shortArgs[256];
+    // maps the ids in strings of the subcommand names to their indexes in
+    // vsubcommands, NO_ARGUMENT for the other strings
+    std::vector<int> subcommands;
+    std::vector<Subcommand> vsubcommands;
+    LongArgumentIndex longArgs;
+    bool allowAbbreviation;
+    std::string environmentPrefix;
+    unsigned int validationThreads;
+    std::vector<std::string> configFiles;
+    std::vector<Constraint> constraints;
+    // the mask of the mandatory arguments
+    std::vector<uint64_t> mandatoryArgs;
+    // the indexes in vargs of the positional arguments, one for each
+    // positional token, the tokens after them go to positionalTail
+    std::vector<int> positionalSlots;
+    // the index in vargs of the positional argument that takes a variable
+    // number of values, if any
+    int positionalTail;
+
+private:
+    typedef std::pmr::vector<std::pmr::string> Tokens;
+    // a bit for each index in vargs
+    typedef std::pmr::vector<uint64_t> Seen;
+    // the order in which the arguments are first seen for the deferred
+    // validation
+    typedef std::pmr::vector<size_t> Positions;
+
+    std::string_view getArg(const StoredArgument& argument) const;
+    void addName(uint32_t stringId, int id);
+    int findArgument(std::string_view arg) const;
+    int findSubcommand(std::string_view name) const;
+    int findDeclaredArgument(const std::string& arg) const;
+    void checkConstraints(const Seen& seen) const;
+    bool expandShortArgs(Tokens& v, size_t start, size_t& i) const;
+    void parse(Tokens& v, size_t start, ParsedArgument& pa);
+    void parseEnvironment(Seen& seen, ParsedArgument& pa) const;
+    void parseConfigFiles(Seen& seen, ParsedArgument& pa) const;
+    void putValues(const StoredArgument& argument, Tokens& values,
+        ParsedArgument::Source source, std::string_view name,
+        ParsedArgument& pa) const;
+    void validate(const StoredArgument& argument, const ParsedArgument& pa) const;
+    void validateDeferred(const Seen& seen, const Positions& positions,
+        const ParsedArgument& pa) const;
+    void renderHelp(const std::string& programName) const;
+
+    mutable std::string help;
+    mutable std::string helpProgramName;
+    mutable bool helpRendered;
 };
 
 } /* namespace cppargparser */
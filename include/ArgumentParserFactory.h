@@ -0,0 +1,39 @@
+// Copyright 2012, Fredy Wijaya
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the Lesser GNU General Public License as published by
+// the Free Software Foundation, either version 3.0 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// Lesser GNU General Public License for more details.
+//
+// You should have received a copy of the Lesser GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>
+
+#ifndef ARGUMENTPARSERFACTORY_H_
+#define ARGUMENTPARSERFACTORY_H_
+
+#include "Export.h"
+
+namespace cppargparser {
+
+class ArgumentParser;
+
+class CPPARGPARSER_API ArgumentParserFactory {
+public:
+    /**
+     * Creates the argument parser of a subcommand. This is only called when
+     * the subcommand is selected.
+     * @return a new argument parser, the caller takes the ownership
+     */
+    virtual ArgumentParser* create() const = 0;
+
+    virtual ~ArgumentParserFactory() {}
+};
+
+}
+
+#endif /* ARGUMENTPARSERFACTORY_H_ */
@@ -17,12 +17,13 @@
 #define ARGUMENTPARSERUTILS_H_
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <sstream>
 
 namespace cppargparser {
 
-bool isShortArg(const std::string& s) {
+inline bool isShortArg(std::string_view s) {
     if (s.size() > 1) {
         if (s[0] == '-') {
             return true;
@@ -31,16 +32,21 @@ bool isShortArg(const std::string& s) {
     return false;
 }
 
-bool isLongArg(const std::string& s) {
+inline bool isLongArg(std::string_view s) {
     if (s.size() > 2) {
-        if (s.substr(0, 2) == "--") {
+        if (s[0] == '-' && s[1] == '-') {
             return true;
         }
     }
     return false;
 }
 
-std::string toString(const std::vector<std::string>& v) {
+// a single check for isShortArg(s) || isLongArg(s)
+inline bool isOption(std::string_view s) {
+    return s.size() > 1 && s[0] == '-';
+}
+
+inline std::string toString(const std::vector<std::string>& v) {
     using namespace std;
     string s = "[";
     for (vector<string>::const_iterator i = v.begin(); i != v.end(); ++i) {
@@ -52,7 +58,7 @@ std::string toString(const std::vector<std::string>& v) {
     return s;
 }
 
-std::string toString(int i) {
+inline std::string toString(int i) {
     using namespace std;
     stringstream ss;
     ss << i;
@@ -0,0 +1,113 @@
+// Copyright 2012, Fredy Wijaya
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the Lesser GNU General Public License as published by
+// the Free Software Foundation, either version 3.0 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// Lesser GNU General Public License for more details.
+//
+// You should have received a copy of the Lesser GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>
+
+#ifndef CACHINGVALIDATOR_H_
+#define CACHINGVALIDATOR_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Export.h"
+#include "Validator.h"
+
+namespace cppargparser {
+
+/**
+ * A validator that remembers the results of another validator, so that the
+ * same values aren't validated again, e.g. when parsing many command lines
+ * with the same host names. The cache is a fixed size table of slots picked
+ * by a seeded hash of the value bytes. Each slot keeps a copy of the
+ * values next to the result, so a cached result is only returned for the
+ * very same values; a newer result replaces an older one in the same slot.
+ * Values longer than MAX_CACHED_LENGTH are always validated. Looking up and
+ * storing never lock, but the wrapped validator must be thread-safe if
+ * validate is called from many threads.
+ */
+class CPPARGPARSER_API CachingValidator : public Validator {
+public:
+    static const size_t DEFAULT_SIZE = 1024;
+
+    /**
+     * The length of the longest cached values in bytes, counting a byte for
+     * the size of each value.
+     */
+    static const size_t MAX_CACHED_LENGTH = 56;
+
+    /**
+     * Creates a new instance of CachingValidator.
+     * @param validator the validator whose results are cached, it must
+     *        outlive this validator
+     * @param size the number of cached results, rounded up to a power of 2
+     */
+    CachingValidator(const Validator* validator, size_t size = DEFAULT_SIZE);
+
+    /**
+     * Creates a new instance of CachingValidator that shares the ownership
+     * of the validator whose results are cached.
+     * @param validator the validator whose results are cached
+     * @param size the number of cached results, rounded up to a power of 2
+     */
+    CachingValidator(std::shared_ptr<const Validator> validator,
+        size_t size = DEFAULT_SIZE);
+
+    /**
+     * Validates the argument with the cached result or with the wrapped
+     * validator if there's no cached result.
+     * @param values the argument values
+     */
+    virtual bool validate(const std::vector<std::string>& values) const;
+
+    /**
+     * Validates the argument with the cached result or with the wrapped
+     * validator if there's no cached result.
+     * @param values the argument values
+     */
+    virtual bool validate(const ValueList& values) const;
+
+    virtual ~CachingValidator();
+
+private:
+    CachingValidator(const CachingValidator&);
+    CachingValidator& operator=(const CachingValidator&);
+
+    void init(size_t size);
+    template <typename Values>
+    bool validateValues(const Values& values) const;
+
+    static const size_t WORDS = MAX_CACHED_LENGTH / 8;
+
+    // a seqlock around the cached values, so that a reader never returns a
+    // result stored for other values
+    struct Slot {
+        // odd while a result is being stored
+        std::atomic<uint64_t> sequence;
+        // the values length plus 1 shifted left by 1 and the result, 0 is
+        // an empty slot
+        std::atomic<uint64_t> header;
+        // the size and bytes of each value, padded with zeros
+        std::atomic<uint64_t> words[WORDS];
+    };
+
+    std::shared_ptr<const Validator> validator;
+    size_t mask;
+    uint64_t seed;
+    std::unique_ptr<Slot[]> slots;
+};
+
+} /* namespace cppargparser */
+#endif /* CACHINGVALIDATOR_H_ */
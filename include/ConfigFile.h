@@ -0,0 +1,132 @@
+// Copyright 2012, Fredy Wijaya
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the Lesser GNU General Public License as published by
+// the Free Software Foundation, either version 3.0 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// Lesser GNU General Public License for more details.
+//
+// You should have received a copy of the Lesser GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>
+
+#ifndef CONFIGFILE_H_
+#define CONFIGFILE_H_
+
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+#include <vector>
+#include "Export.h"
+
+namespace cppargparser {
+
+/**
+ * A memory mapped configuration file in a subset of the INI/TOML format:
+ *
+ *     # comment
+ *     log-level = debug
+ *     name = "quoted value"
+ *     hosts = ["foo", "bar"]
+ *     [section]
+ *     key = value
+ *
+ * The entries point into the mapped file, so no string is allocated while
+ * the file is read. Keys inside a section are qualified with the section
+ * name, e.g. section.key. Escape sequences and multi-line values are not
+ * supported.
+ */
+class CPPARGPARSER_API ConfigFile {
+public:
+    struct Entry {
+        const char* section;
+        size_t sectionSize;
+        const char* key;
+        size_t keySize;
+        const char* value;
+        size_t valueSize;
+        int line;
+    };
+
+    /**
+     * Creates a new instance of ConfigFile by reading the given file. A file
+     * that doesn't exist or can't be read has no entries.
+     * @param path the file path
+     * @param resource the memory resource for the entries
+     * @throw InvalidArgumentException if the file has an invalid line
+     */
+    explicit ConfigFile(const std::string& path,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    /**
+     * Checks if the file was read.
+     * @return true if the file was read; false otherwise
+     */
+    bool isOpen() const;
+
+    /**
+     * Gets the file path.
+     * @return the file path
+     */
+    std::string getPath() const;
+
+    /**
+     * Gets the entries in the order they appear in the file.
+     * @return the entries
+     */
+    const std::pmr::vector<Entry>& getEntries() const;
+
+    /**
+     * Gets the entry key qualified with its section, e.g. section.key. The
+     * key is assigned to the given string so that its buffer can be reused.
+     * @param entry the entry
+     * @param key the string to assign the key to
+     */
+    static void getKey(const Entry& entry, std::string& key);
+
+    /**
+     * Gets the entry key qualified with its section, e.g. section.key.
+     * @param entry the entry
+     * @param key the string to assign the key to
+     */
+    static void getKey(const Entry& entry, std::pmr::string& key);
+
+    /**
+     * Gets the entry values. A value in brackets is an array, each element
+     * is a value. Quotes around a value are removed.
+     * @param entry the entry
+     * @param values the vector to add the values to
+     */
+    static void getValues(const Entry& entry, std::vector<std::string>& values);
+
+    /**
+     * Gets the entry values. A value in brackets is an array, each element
+     * is a value. Quotes around a value are removed.
+     * @param entry the entry
+     * @param values the vector to add the values to, the values use its
+     *        memory resource
+     */
+    static void getValues(const Entry& entry,
+        std::pmr::vector<std::pmr::string>& values);
+
+    virtual ~ConfigFile();
+
+private:
+    ConfigFile(const ConfigFile&);
+    ConfigFile& operator=(const ConfigFile&);
+
+    void read(const char* begin, const char* end);
+
+    std::pmr::string path;
+    bool open;
+    const char* data;
+    size_t size;
+    std::pmr::vector<char> buffer;
+    std::pmr::vector<Entry> entries;
+};
+
+} /* namespace cppargparser */
+#endif /* CONFIGFILE_H_ */
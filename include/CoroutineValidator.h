@@ -0,0 +1,125 @@
+// Copyright 2012, Fredy Wijaya
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the Lesser GNU General Public License as published by
+// the Free Software Foundation, either version 3.0 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// Lesser GNU General Public License for more details.
+//
+// You should have received a copy of the Lesser GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>
+
+#ifndef COROUTINEVALIDATOR_H_
+#define COROUTINEVALIDATOR_H_
+
+#if __cplusplus < 202002L
+#error "CoroutineValidator.h requires C++20"
+#endif
+
+#include <coroutine>
+#include <exception>
+#include <future>
+#include <string>
+#include <vector>
+#include "Validator.h"
+
+namespace cppargparser {
+
+/**
+ * The coroutine returned by CoroutineValidator::check. The coroutine starts
+ * right away and destroys itself once it has returned its result.
+ */
+class ValidationTask {
+public:
+    struct promise_type {
+        std::promise<bool> result;
+
+        ValidationTask get_return_object() {
+            return ValidationTask(result.get_future());
+        }
+
+        std::suspend_never initial_suspend() noexcept {
+            return std::suspend_never();
+        }
+
+        std::suspend_never final_suspend() noexcept {
+            return std::suspend_never();
+        }
+
+        void return_value(bool valid) {
+            result.set_value(valid);
+        }
+
+        void unhandled_exception() {
+            result.set_exception(std::current_exception());
+        }
+    };
+
+    /**
+     * Gets the result of the coroutine. This can only be called once.
+     * @return the result of the coroutine
+     */
+    std::future<bool> getResult() {
+        return std::move(result);
+    }
+
+private:
+    explicit ValidationTask(std::future<bool> _result) : result(std::move(_result)) {}
+
+    std::future<bool> result;
+};
+
+/**
+ * A validator written as a C++20 coroutine, e.g. one that awaits a check
+ * that a path exists or that a socket is listening. With deferred
+ * validation, ArgumentParser starts all the coroutines before waiting for
+ * any of them, so their checks run at the same time, see
+ * ArgumentParser::setValidationThreads. Otherwise validate waits for the
+ * coroutine. Either way the coroutine must be resumed by another thread,
+ * e.g. an I/O thread, because the parsing thread blocks on the result.
+ *
+ * Example:
+ *     class PathValidator : public CoroutineValidator {
+ *     public:
+ *         ValidationTask check(std::vector<std::string> values) const {
+ *             for (const std::string& path : values) {
+ *                 if (!co_await io.exists(path)) {
+ *                     co_return false;
+ *                 }
+ *             }
+ *             co_return true;
+ *         }
+ *     };
+ */
+class CoroutineValidator : public Validator {
+public:
+    /**
+     * Validates the argument.
+     * @param values a copy of the argument values, so that they live as long
+     *        as the coroutine
+     * @return the coroutine, co_return true if the values are valid; false
+     *         otherwise
+     */
+    virtual ValidationTask check(std::vector<std::string> values) const = 0;
+
+    virtual bool validate(const std::vector<std::string>& values) const {
+        return check(values).getResult().get();
+    }
+
+    virtual bool validate(const ValueList& values) const {
+        return check(values).getResult().get();
+    }
+
+    virtual std::future<bool> validateAsync(const ValueList& values) const {
+        return check(values).getResult();
+    }
+
+    virtual ~CoroutineValidator() {}
+};
+
+} /* namespace cppargparser */
+#endif /* COROUTINEVALIDATOR_H_ */
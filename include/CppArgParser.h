@@ -0,0 +1,58 @@
+// Copyright 2012, Fredy Wijaya
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the Lesser GNU General Public License as published by
+// the Free Software Foundation, either version 3.0 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// Lesser GNU General Public License for more details.
+//
+// You should have received a copy of the Lesser GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>
+
+#ifndef CPPARGPARSER_H_
+#define CPPARGPARSER_H_
+
+/**
+ * Includes the whole library. Define CPPARGPARSER_IMPLEMENTATION before
+ * including this header in exactly one translation unit, e.g. the one with
+ * main, to compile the library into it instead of linking libcppargparser.
+ * The compiler then sees the whole parser and can inline it into the caller.
+ *
+ * Example:
+ *     #define CPPARGPARSER_IMPLEMENTATION
+ *     #include "CppArgParser.h"
+ */
+
+#include "Argument.h"
+#include "ArgumentParser.h"
+#include "ArgumentParserFactory.h"
+#include "CachingValidator.h"
+#include "ConfigFile.h"
+#include "InvalidArgumentException.h"
+#include "LongArgumentIndex.h"
+#include "ParsedArgument.h"
+#include "PatternValidator.h"
+#include "StringPool.h"
+#include "Validator.h"
+#include "ValidatorPipeline.h"
+
+#endif /* CPPARGPARSER_H_ */
+
+// the sources use using namespace std and internal helpers, so they can only
+// be compiled once per program
+#if defined(CPPARGPARSER_IMPLEMENTATION) && !defined(CPPARGPARSER_IMPLEMENTED_)
+#define CPPARGPARSER_IMPLEMENTED_
+#include "../src/Argument.cpp"
+#include "../src/ArgumentParser.cpp"
+#include "../src/CachingValidator.cpp"
+#include "../src/ConfigFile.cpp"
+#include "../src/LongArgumentIndex.cpp"
+#include "../src/ParsedArgument.cpp"
+#include "../src/PatternValidator.cpp"
+#include "../src/StringPool.cpp"
+#include "../src/ValidatorPipeline.cpp"
+#endif
@@ -0,0 +1,27 @@
+// Copyright 2012, Fredy Wijaya
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the Lesser GNU General Public License as published by
+// the Free Software Foundation, either version 3.0 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// Lesser GNU General Public License for more details.
+//
+// You should have received a copy of the Lesser GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>
+
+#ifndef EXPORT_H_
+#define EXPORT_H_
+
+// marks the public classes so that they stay visible when the library is
+// built with -fvisibility=hidden, e.g. by the release targets
+#if defined(__GNUC__)
+#define CPPARGPARSER_API __attribute__((visibility("default")))
+#else
+#define CPPARGPARSER_API
+#endif
+
+#endif /* EXPORT_H_ */
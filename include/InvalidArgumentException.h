@@ -18,10 +18,11 @@
 
 #include <string>
 #include <exception>
+#include "Export.h"
 
 namespace cppargparser {
 
-class InvalidArgumentException : public std::exception {
+class CPPARGPARSER_API InvalidArgumentException : public std::exception {
 public:
     InvalidArgumentException(const std::string& _message) : message(_message) {}
 
@@ -0,0 +1,82 @@
+// Copyright 2012, Fredy Wijaya
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the Lesser GNU General Public License as published by
+// the Free Software Foundation, either version 3.0 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// Lesser GNU General Public License for more details.
+//
+// You should have received a copy of the Lesser GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>
+
+#ifndef LONGARGUMENTINDEX_H_
+#define LONGARGUMENTINDEX_H_
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Export.h"
+
+namespace cppargparser {
+
+/**
+ * A radix trie of long argument names that resolves unique prefixes, e.g.
+ * --verb to --verbose, in O(length of the prefix).
+ */
+class CPPARGPARSER_API LongArgumentIndex {
+public:
+    static const int NOT_FOUND = -1;
+    static const int AMBIGUOUS = -2;
+
+    LongArgumentIndex();
+
+    /**
+     * Adds a long argument name. A name that is already added keeps its
+     * first id.
+     * @param name the long argument name
+     * @param id the id returned by find, must not be negative
+     */
+    void add(const std::string& name, int id);
+
+    /**
+     * Finds a long argument name by its name or by its unique prefix. An
+     * exact match always wins over a longer name with the same prefix.
+     * @param prefix the long argument name or its prefix
+     * @return the id of the long argument, NOT_FOUND if there is no long
+     *         argument with the given prefix or AMBIGUOUS if there are
+     *         more than one
+     */
+    int find(std::string_view prefix) const;
+
+    /**
+     * Removes all the long argument names.
+     */
+    void clear();
+
+    virtual ~LongArgumentIndex();
+
+private:
+    struct Node {
+        // the edge label from the parent node
+        std::string label;
+        // the id of the name ending at this node or NOT_FOUND
+        int id;
+        // the number of names in this subtree and one of their ids
+        int count;
+        int anyId;
+        // child node indexes sorted by the first character of their labels
+        std::vector<size_t> children;
+    };
+
+    size_t findChild(const Node& node, char c) const;
+    size_t newNode(const std::string& label, int id, int count, int anyId);
+
+    std::vector<Node> nodes;
+};
+
+} /* namespace cppargparser */
+#endif /* LONGARGUMENTINDEX_H_ */
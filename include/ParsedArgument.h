@@ -17,19 +17,98 @@
 #define PARSEDARGUMENT_H_
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map>
+#include <memory_resource>
+#include "Export.h"
 
 namespace cppargparser {
 
-class ParsedArgument {
+class ArgumentParser;
+
+/**
+ * A read-only view of the values of an argument. The view is only valid as
+ * long as the ParsedArgument it came from is neither modified nor destroyed.
+ */
+class CPPARGPARSER_API ValueList {
 public:
+    typedef std::pmr::vector<std::pmr::string>::const_iterator const_iterator;
+
+    /**
+     * Creates a new instance of ValueList.
+     * @param values the values
+     */
+    explicit ValueList(const std::pmr::vector<std::pmr::string>& values) :
+        values(&values) {}
+
+    const_iterator begin() const { return values->begin(); }
+
+    const_iterator end() const { return values->end(); }
+
+    size_t size() const { return values->size(); }
+
+    bool empty() const { return values->empty(); }
+
+    /**
+     * Gets a copy of a value, like the std::vector<std::string> returned by
+     * the earlier versions, e.g. std::string s = pa.getValues("-a")[0].
+     * Use view or the iterators to read a value without copying it.
+     */
+    std::string operator[](size_t i) const {
+        return std::string((*values)[i]);
+    }
+
+    /**
+     * Gets a value without copying it.
+     */
+    std::string_view view(size_t i) const { return (*values)[i]; }
+
+    /**
+     * Copies the values into a std::vector.
+     */
+    operator std::vector<std::string>() const {
+        return std::vector<std::string>(values->begin(), values->end());
+    }
+
+private:
+    const std::pmr::vector<std::pmr::string>* values;
+};
+
+class CPPARGPARSER_API ParsedArgument {
+public:
+    enum Source { COMMAND_LINE, ENVIRONMENT, CONFIG_FILE };
+
+    /**
+     * Creates a new instance of ParsedArgument.
+     * @param resource the memory resource for all the arguments and values,
+     *                 e.g. a std::pmr::monotonic_buffer_resource to release
+     *                 a whole parse at once
+     */
+    explicit ParsedArgument(
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    /**
+     * Creates a copy of ParsedArgument. Like the standard containers, the
+     * copy uses the default memory resource.
+     */
+    ParsedArgument(const ParsedArgument& other) = default;
+
+    /**
+     * Moves a ParsedArgument. The memory resource moves along.
+     */
+    ParsedArgument(ParsedArgument&& other) = default;
+
+    ParsedArgument& operator=(const ParsedArgument& other) = default;
+
+    ParsedArgument& operator=(ParsedArgument&& other) = default;
+
     /**
      * Puts the argument and argument value.
      * @param arg the argument
      * @param value the argument value
      */
-    void putArgument(const std::string& arg, const std::string& value);
+    void putArgument(std::string_view arg, std::string_view value);
 
     /**
      * Gets the argument value.
@@ -39,11 +118,19 @@ public:
     std::string getValue(const std::string& arg) const;
 
     /**
-     * Gets the argument values.
+     * Gets the argument values without copying them.
+     * @param arg the argument
+     * @return the view of the argument values
+     */
+    ValueList getValues(const std::string& arg) const;
+
+    /**
+     * Moves the argument values out. The argument is still there afterwards
+     * but without any values.
      * @param arg the argument
-     * @return the argument values
+     * @return the argument values, allocated from the memory resource
      */
-    std::vector<std::string> getValues(const std::string& arg) const;
+    std::pmr::vector<std::pmr::string> takeValues(const std::string& arg);
 
     /**
      * Checks if the given arg was called.
@@ -51,10 +138,78 @@ public:
      */
     bool hasArgument(const std::string& arg) const;
 
+    /**
+     * Gets the number of times the argument was given, with any duplicate
+     * policy that accepts repeated arguments. Flags, i.e. arguments without
+     * values, only store this count, e.g. -v -v -v or -vvv gives 3, and
+     * always have a single empty value.
+     * @param arg the argument
+     * @return the number of times the argument was given, 0 if it wasn't
+     */
+    unsigned int getCount(const std::string& arg) const;
+
+    /**
+     * Sets where the argument values came from.
+     * @param arg the argument
+     * @param source the source of the argument values
+     */
+    void setSource(const std::string& arg, Source source);
+
+    /**
+     * Gets where the argument values came from.
+     * @param arg the argument
+     * @return the source of the argument values
+     */
+    Source getSource(const std::string& arg) const;
+
+    /**
+     * Sets the selected subcommand.
+     * @param subcommand the subcommand name
+     */
+    void setSubcommand(std::string_view subcommand);
+
+    /**
+     * Gets the selected subcommand.
+     * @return the subcommand name
+     */
+    std::string getSubcommand() const;
+
+    /**
+     * Checks if a subcommand was selected.
+     * @return true if a subcommand was selected; false otherwise
+     */
+    bool hasSubcommand() const;
+
+    /**
+     * Gets the memory resource.
+     * @return the memory resource
+     */
+    std::pmr::memory_resource* getMemoryResource() const;
+
     virtual ~ParsedArgument();
 
 private:
-    std::map<std::string, std::vector<std::string> > args;
+    // ArgumentParser stores each value once for both the short and the long
+    // argument and moves the values out of the tokens
+    friend class ArgumentParser;
+
+    typedef std::pmr::vector<std::pmr::string> Values;
+    // maps the argument names to their indexes in values, sources, counts
+    // and flags, std::less<> allows looking up the std::pmr::string keys with a
+    // std::string_view without allocating a key
+    typedef std::pmr::map<std::pmr::string, size_t, std::less<> > ArgumentMap;
+
+    size_t findOrAdd(std::string_view arg);
+    size_t findOrAdd(std::string_view shortArg, std::string_view longArg);
+    const Values& find(std::string_view arg) const;
+
+    ArgumentMap args;
+    std::pmr::vector<Values> values;
+    std::pmr::vector<Source> sources;
+    std::pmr::vector<unsigned int> counts;
+    // the arguments without values, they have a single empty value
+    std::pmr::vector<bool> flags;
+    std::pmr::string subcommand;
 };
 
 } /* namespace cppargparser */
@@ -0,0 +1,96 @@
+// Copyright 2012, Fredy Wijaya
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the Lesser GNU General Public License as published by
+// the Free Software Foundation, either version 3.0 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// Lesser GNU General Public License for more details.
+//
+// You should have received a copy of the Lesser GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>
+
+#ifndef PATTERNVALIDATOR_H_
+#define PATTERNVALIDATOR_H_
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Export.h"
+#include "Validator.h"
+
+namespace cppargparser {
+
+/**
+ * A validator that accepts the values fully matching a regular expression.
+ * The pattern is compiled once into a DFA when the validator is created, so
+ * matching is a table lookup per character without backtracking, and the
+ * validator can be used from many threads at the same time.
+ *
+ * The supported syntax is a subset of ECMAScript: literals, . (any byte but
+ * \n and \r), [a-z], [^a-z], \d, \w, \s (and \D, \W, \S), \t, \n, \r, \f,
+ * \v, \0, \xHH, groups, |, *, +, ?, {m}, {m,} and {m,n}. Other punctuation
+ * can be escaped with a backslash. In [], an escaped character can start or
+ * end a range, e.g. [\x00-\x1f], but \d, \w and \s can't. Any other escaped
+ * letter or digit, e.g. a backreference or \b outside of [], is an invalid
+ * pattern.
+ *
+ * Example:
+ *     PatternValidator validator("[a-z0-9.-]+:\\d{1,5}");
+ */
+class CPPARGPARSER_API PatternValidator : public Validator {
+public:
+    /**
+     * Creates a new instance of PatternValidator.
+     * @param pattern the regular expression
+     * @throws InvalidArgumentException if the pattern is invalid or too
+     *         complex
+     */
+    explicit PatternValidator(const std::string& pattern);
+
+    /**
+     * Checks if a value fully matches the pattern.
+     * @param value the value
+     * @return true if the value matches; false otherwise
+     */
+    bool matches(std::string_view value) const;
+
+    /**
+     * Validates the argument.
+     * @param values the argument values
+     * @return true if all the values match the pattern; false otherwise
+     */
+    virtual bool validate(const std::vector<std::string>& values) const;
+
+    /**
+     * Validates the argument without copying the values.
+     * @param values the argument values
+     * @return true if all the values match the pattern; false otherwise
+     */
+    virtual bool validate(const ValueList& values) const;
+
+    /**
+     * Gets the pattern.
+     * @return the pattern
+     */
+    const std::string& getPattern() const;
+
+    virtual ~PatternValidator();
+
+private:
+    static const int DEAD = -1;
+
+    std::string pattern;
+    // the bytes that the pattern doesn't tell apart share a column
+    unsigned char columns[256];
+    size_t numColumns;
+    // the next state of each state and column, the start state is 0
+    std::vector<int> transitions;
+    std::vector<char> accepting;
+};
+
+} /* namespace cppargparser */
+#endif /* PATTERNVALIDATOR_H_ */
@@ -0,0 +1,215 @@
+// Copyright 2012, Fredy Wijaya
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the Lesser GNU General Public License as published by
+// the Free Software Foundation, either version 3.0 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// Lesser GNU General Public License for more details.
+//
+// You should have received a copy of the Lesser GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>
+
+#ifndef STATICARGUMENTPARSER_H_
+#define STATICARGUMENTPARSER_H_
+
+#if __cplusplus < 201703L
+#error "StaticArgumentParser.h requires C++17"
+#endif
+
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include "ArgumentParser.h"
+
+namespace cppargparser {
+
+/**
+ * An argument declared at compile time. Use an empty string for a missing
+ * short or long argument.
+ */
+struct StaticArgument {
+    const char* shortArg;
+    const char* longArg;
+    const char* description;
+    int numArgs;
+    bool mandatory;
+};
+
+/**
+ * A subcommand declared at compile time. The factory must have static
+ * storage duration.
+ */
+struct StaticSubcommand {
+    const char* name;
+    const char* description;
+    const ArgumentParserFactory* factory;
+};
+
+namespace detail {
+
+// the layout here must be kept in sync with ArgumentParser::renderHelp
+const std::size_t HELP_INDENT = 4;
+const std::size_t HELP_GAP = 4;
+const char OPTIONS_HEADER[] = "Options:\n";
+const char COMMANDS_HEADER[] = "Commands:\n";
+
+inline constexpr std::array<StaticSubcommand, 0> NO_SUBCOMMANDS{};
+
+constexpr std::size_t length(const char* s) {
+    std::size_t n = 0;
+    while (s[n] != '\0') {
+        ++n;
+    }
+    return n;
+}
+
+constexpr std::size_t optionLength(const StaticArgument& arg) {
+    std::size_t shortLength = length(arg.shortArg);
+    std::size_t longLength = length(arg.longArg);
+    std::size_t separatorLength = (shortLength > 0 && longLength > 0) ? 2 : 0;
+    return shortLength + separatorLength + longLength;
+}
+
+template <typename Arguments, typename Subcommands>
+constexpr std::size_t optionWidth(const Arguments& args, const Subcommands& subcommands) {
+    std::size_t width = 0;
+    for (const StaticArgument& arg : args) {
+        if (optionLength(arg) > width) {
+            width = optionLength(arg);
+        }
+    }
+    for (const StaticSubcommand& subcommand : subcommands) {
+        if (length(subcommand.name) > width) {
+            width = length(subcommand.name);
+        }
+    }
+    return width + HELP_GAP;
+}
+
+template <typename Arguments, typename Subcommands>
+constexpr std::size_t helpLength(const Arguments& args, const Subcommands& subcommands) {
+    std::size_t width = optionWidth(args, subcommands);
+    std::size_t n = length(OPTIONS_HEADER);
+    for (const StaticArgument& arg : args) {
+        n += HELP_INDENT + width + length(arg.description) + 1;
+    }
+    if (std::size(subcommands) > 0) {
+        n += length(COMMANDS_HEADER);
+    }
+    for (const StaticSubcommand& subcommand : subcommands) {
+        n += HELP_INDENT + width + length(subcommand.description) + 1;
+    }
+    return n;
+}
+
+template <std::size_t Size>
+constexpr std::size_t append(std::array<char, Size>& text, std::size_t pos,
+    const char* s) {
+    for (std::size_t i = 0; s[i] != '\0'; ++i) {
+        text[pos++] = s[i];
+    }
+    return pos;
+}
+
+template <std::size_t Size>
+constexpr std::size_t append(std::array<char, Size>& text, std::size_t pos,
+    std::size_t n, char c) {
+    for (std::size_t i = 0; i < n; ++i) {
+        text[pos++] = c;
+    }
+    return pos;
+}
+
+template <std::size_t Size, typename Arguments, typename Subcommands>
+constexpr std::array<char, Size> renderHelp(const Arguments& args,
+    const Subcommands& subcommands) {
+    std::array<char, Size> text{};
+    std::size_t width = optionWidth(args, subcommands);
+    std::size_t pos = append(text, 0, OPTIONS_HEADER);
+    for (const StaticArgument& arg : args) {
+        pos = append(text, pos, HELP_INDENT, ' ');
+        pos = append(text, pos, arg.shortArg);
+        if (length(arg.shortArg) > 0 && length(arg.longArg) > 0) {
+            pos = append(text, pos, ", ");
+        }
+        pos = append(text, pos, arg.longArg);
+        pos = append(text, pos, width - optionLength(arg), ' ');
+        pos = append(text, pos, arg.description);
+        pos = append(text, pos, 1, '\n');
+    }
+    if (std::size(subcommands) > 0) {
+        pos = append(text, pos, COMMANDS_HEADER);
+    }
+    for (const StaticSubcommand& subcommand : subcommands) {
+        pos = append(text, pos, HELP_INDENT, ' ');
+        pos = append(text, pos, subcommand.name);
+        pos = append(text, pos, width - length(subcommand.name), ' ');
+        pos = append(text, pos, subcommand.description);
+        pos = append(text, pos, 1, '\n');
+    }
+    return text;
+}
+
+} /* namespace detail */
+
+/**
+ * An argument parser whose arguments and subcommands are declared at compile
+ * time. The help menu after the usage line is rendered by the compiler, so
+ * showHelp only has to put the program name in front of it.
+ *
+ * Example:
+ *     constexpr StaticArgument arguments[] = {
+ *         { "-p", "--port", "Port Number", 1, true },
+ *         { "-v", "", "Verbose", 0, false }
+ *     };
+ *     constexpr StaticSubcommand subcommands[] = {
+ *         { "build", "build a target", &buildFactory }
+ *     };
+ *     StaticArgumentParser<arguments, subcommands> argParser;
+ */
+template <const auto& Arguments, const auto& Subcommands = detail::NO_SUBCOMMANDS>
+class StaticArgumentParser : public ArgumentParser {
+public:
+    static constexpr std::size_t HELP_SIZE = detail::helpLength(Arguments, Subcommands);
+    static constexpr std::array<char, HELP_SIZE> HELP =
+        detail::renderHelp<HELP_SIZE>(Arguments, Subcommands);
+
+    /**
+     * Creates a new instance of StaticArgumentParser with all the arguments
+     * and subcommands declared at compile time already added.
+     */
+    StaticArgumentParser() {
+        for (const StaticArgument& arg : Arguments) {
+            addArgument(Argument(arg.shortArg, arg.longArg, arg.description,
+                arg.numArgs, arg.mandatory));
+        }
+        for (const StaticSubcommand& subcommand : Subcommands) {
+            addSubcommand(subcommand.name, subcommand.description, subcommand.factory);
+        }
+    }
+
+    /**
+     * Shows/prints the help menu rendered at compile time without
+     * allocating, the usage line and the help go to the buffer of std::cout
+     * and are flushed together.
+     * @param programName the program name
+     */
+    virtual void showHelp(const std::string& programName) const {
+        std::cout.write("Usage: ", 7);
+        std::cout.write(programName.data(), programName.size());
+        std::cout.put('\n');
+        std::cout.write(HELP.data(), HELP.size());
+        std::cout.flush();
+    }
+
+    virtual ~StaticArgumentParser() {}
+};
+
+} /* namespace cppargparser */
+#endif /* STATICARGUMENTPARSER_H_ */
@@ -0,0 +1,100 @@
+// Copyright 2012, Fredy Wijaya
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the Lesser GNU General Public License as published by
+// the Free Software Foundation, either version 3.0 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// Lesser GNU General Public License for more details.
+//
+// You should have received a copy of the Lesser GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>
+
+#ifndef STRINGPOOL_H_
+#define STRINGPOOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+#include "Export.h"
+
+namespace cppargparser {
+
+/**
+ * A pool of interned strings. Each distinct string is stored once and
+ * referenced by a 32-bit id, so equal strings can be compared by their ids.
+ * The ids are assigned in the order the strings are first interned,
+ * starting from 0.
+ */
+class CPPARGPARSER_API StringPool {
+public:
+    static const uint32_t NOT_FOUND = 0xffffffff;
+
+    /**
+     * Interns a string.
+     * @param s the string
+     * @return the id of the string, the same id is returned for equal strings
+     */
+    uint32_t intern(std::string_view s);
+
+    /**
+     * Finds an interned string without interning it.
+     * @param s the string
+     * @return the id of the string or NOT_FOUND if it isn't interned
+     */
+    uint32_t find(std::string_view s) const;
+
+    /**
+     * Gets an interned string. The returned view is valid as long as this
+     * pool is.
+     * @param id the id of the string
+     * @return the string
+     */
+    std::string_view get(uint32_t id) const;
+
+    /**
+     * Gets the number of interned strings.
+     * @return the number of interned strings
+     */
+    size_t size() const;
+
+    /**
+     * Gets the number of bytes used to store the interned strings.
+     * @return the number of bytes
+     */
+    size_t getBytes() const;
+
+    StringPool();
+
+    StringPool(const StringPool& other);
+
+    StringPool& operator=(const StringPool& other);
+
+    ~StringPool();
+
+private:
+    static const size_t CHUNK_SIZE = 4096;
+
+    size_t findSlot(std::string_view s) const;
+    void grow();
+
+    // the characters are stored in chunks that never move, so the views in
+    // strings and ids stay valid while the pool grows
+    std::vector<std::unique_ptr<char[]> > chunks;
+    size_t chunkUsed;
+    size_t chunkCapacity;
+    size_t bytes;
+    std::vector<std::string_view> strings;
+    // an open addressing table of the ids in strings, at most half full,
+    // NOT_FOUND is an empty slot. A slot is 4 bytes instead of a node of a
+    // std::unordered_map, which matters for many short strings
+    std::vector<uint32_t> ids;
+};
+
+} /* namespace cppargparser */
+#endif /* STRINGPOOL_H_ */
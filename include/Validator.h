@@ -16,22 +16,71 @@
 #ifndef VALIDATOR_H_
 #define VALIDATOR_H_
 
+#include <future>
+#include <memory>
 #include <string>
 #include <vector>
+#include "Export.h"
+#include "ParsedArgument.h"
 
 namespace cppargparser {
 
-class Validator {
+/**
+ * Validates the argument values. validate is const, so that a validator can
+ * be shared by many arguments, parsers and threads, e.g. with a
+ * std::shared_ptr<const Validator>.
+ */
+class CPPARGPARSER_API Validator {
 public:
     /**
      * Validates the argument.
      * @param values the argument values
      */
-    virtual bool validate(const std::vector<std::string>& values) = 0;
+    virtual bool validate(const std::vector<std::string>& values) const = 0;
+
+    /**
+     * Validates the argument without copying the values. Override this to
+     * avoid the copy made for the other validate.
+     * @param values the argument values
+     */
+    virtual bool validate(const ValueList& values) const {
+        return validate(static_cast<std::vector<std::string> >(values));
+    }
+
+    /**
+     * Starts validating the argument, e.g. a check that needs I/O, without
+     * waiting for the result. ArgumentParser starts all the deferred
+     * validations before waiting for any of them, see
+     * ArgumentParser::setValidationThreads. By default the argument is
+     * validated right away.
+     * @param values the argument values, they stay valid until the result
+     *        is ready
+     * @return the result of the validation
+     */
+    virtual std::future<bool> validateAsync(const ValueList& values) const {
+        std::promise<bool> result;
+        try {
+            result.set_value(validate(values));
+        } catch (...) {
+            result.set_exception(std::current_exception());
+        }
+        return result.get_future();
+    }
 
     virtual ~Validator() {}
 };
 
+/**
+ * Wraps a validator owned elsewhere into a std::shared_ptr that never
+ * deletes it, for the classes that share the ownership of their validators.
+ * @param validator the validator, it must outlive all the copies of the
+ *        returned pointer
+ * @return an empty std::shared_ptr aliasing the validator
+ */
+inline std::shared_ptr<const Validator> unownedValidator(const Validator* validator) {
+    return std::shared_ptr<const Validator>(std::shared_ptr<const Validator>(), validator);
+}
+
 }
 
 #endif /* VALIDATOR_H_ */
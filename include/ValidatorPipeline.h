@@ -0,0 +1,133 @@
+// Copyright 2012, Fredy Wijaya
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the Lesser GNU General Public License as published by
+// the Free Software Foundation, either version 3.0 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// Lesser GNU General Public License for more details.
+//
+// You should have received a copy of the Lesser GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>
+
+#ifndef VALIDATORPIPELINE_H_
+#define VALIDATORPIPELINE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Export.h"
+#include "Validator.h"
+
+namespace cppargparser {
+
+/**
+ * A validator that runs a chain of validators, e.g. a type check, a range
+ * check and a custom predicate, in the order of their declared cost, so that
+ * the cheap checks reject the bad values first. The chain stops at the first
+ * validator that rejects the values. The number of times each validator ran
+ * and rejected the values are kept, so the hot checks can be found.
+ *
+ * Example:
+ *     ValidatorPipeline pipeline;
+ *     pipeline.add(&dnsValidator, 100).add(&portValidator, 1);
+ *     argParser.addArgument(Argument("-s", "--server", "Server", 1, true, &pipeline));
+ */
+class CPPARGPARSER_API ValidatorPipeline : public Validator {
+public:
+    /**
+     * The statistics of a validator in the pipeline.
+     */
+    struct Stats {
+        unsigned int cost;
+        unsigned long executions;
+        unsigned long rejections;
+
+        /**
+         * Gets the fraction of the executions that rejected the values.
+         * @return the rejection rate, 0 if the validator never ran
+         */
+        double getRejectionRate() const;
+    };
+
+    ValidatorPipeline();
+
+    /**
+     * Adds a validator. The validators with the same cost run in the order
+     * they are added. Validators must not be added while validating.
+     * @param validator the validator, it must outlive the pipeline
+     * @param cost the relative cost of the validator
+     * @return this pipeline
+     */
+    ValidatorPipeline& add(const Validator* validator, unsigned int cost);
+
+    /**
+     * Adds a validator whose ownership is shared with the pipeline.
+     * @param validator the validator
+     * @param cost the relative cost of the validator
+     * @return this pipeline
+     */
+    ValidatorPipeline& add(std::shared_ptr<const Validator> validator, unsigned int cost);
+
+    /**
+     * Validates the argument with each validator from the cheapest one until
+     * one of them rejects the values.
+     * @param values the argument values
+     * @return true if all the validators accept the values; false otherwise
+     */
+    virtual bool validate(const std::vector<std::string>& values) const;
+
+    /**
+     * Validates the argument without copying the values.
+     * @param values the argument values
+     * @return true if all the validators accept the values; false otherwise
+     */
+    virtual bool validate(const ValueList& values) const;
+
+    /**
+     * Gets the number of validators.
+     * @return the number of validators
+     */
+    size_t size() const;
+
+    /**
+     * Gets a validator in the order they run.
+     * @param i the index of the validator
+     * @return the validator
+     */
+    const Validator* getValidator(size_t i) const;
+
+    /**
+     * Gets the statistics of a validator in the order they run.
+     * @param i the index of the validator
+     * @return the statistics of the validator
+     */
+    Stats getStats(size_t i) const;
+
+    virtual ~ValidatorPipeline();
+
+private:
+    ValidatorPipeline(const ValidatorPipeline&);
+    ValidatorPipeline& operator=(const ValidatorPipeline&);
+
+    template <typename Values>
+    bool validateValues(const Values& values) const;
+
+    struct Stage {
+        std::shared_ptr<const Validator> validator;
+        unsigned int cost;
+        std::atomic<unsigned long> executions;
+        std::atomic<unsigned long> rejections;
+    };
+
+    // sorted by cost, the stages don't move because of the atomic counters
+    std::vector<std::unique_ptr<Stage> > stages;
+};
+
+} /* namespace cppargparser */
+#endif /* VALIDATORPIPELINE_H_ */
@@ -14,6 +14,8 @@
 // along with this program. If not, see <http://www.gnu.org/licenses/>
 
 #include "Argument.h"
+#include "ArgumentParserUtils.h"
+#include "InvalidArgumentException.h"
 
 using namespace std;
 
@@ -25,8 +27,11 @@ Argument::Argument(const string& _shortArg, const string& _longArg,
     longArg(_longArg),
     description(_desc),
     numArgs(_numArgs),
+    minArgs(_numArgs == INFINITY ? 0 : _numArgs),
+    maxArgs(_numArgs),
     mandatory(_mandatory),
-    validator(NULL) {
+    positional(false),
+    duplicatePolicy(REJECT) {
 }
 
 Argument::Argument(const string& _shortArg, const string& _longArg,
@@ -35,8 +40,12 @@ Argument::Argument(const string& _shortArg, const string& _longArg,
     longArg(_longArg),
     description(_desc),
     numArgs(_numArgs),
-    mandatory(_mandatory) {
-    validator = _validator;
+    minArgs(_numArgs == INFINITY ? 0 : _numArgs),
+    maxArgs(_numArgs),
+    mandatory(_mandatory),
+    positional(false),
+    duplicatePolicy(REJECT) {
+    setValidator(unownedValidator(_validator));
 }
 
 Argument::Argument(const string& _arg, const string& _desc, Type _type,
@@ -45,8 +54,11 @@ Argument::Argument(const string& _arg, const string& _desc, Type _type,
     longArg(""),
     description(_desc),
     numArgs(_numArgs),
+    minArgs(_numArgs == INFINITY ? 0 : _numArgs),
+    maxArgs(_numArgs),
     mandatory(_mandatory),
-    validator(NULL) {
+    positional(false),
+    duplicatePolicy(REJECT) {
     switch (_type) {
     case SHORT:
         shortArg = _arg;
@@ -54,6 +66,12 @@ Argument::Argument(const string& _arg, const string& _desc, Type _type,
     case LONG:
         longArg = _arg;
         break;
+    case POSITIONAL:
+        // the name is kept as the long argument so that the values are
+        // stored under it
+        longArg = _arg;
+        positional = true;
+        break;
     }
 }
 
@@ -63,7 +81,11 @@ Argument::Argument(const string& _arg, const string& _desc, Type _type,
     longArg(""),
     description(_desc),
     numArgs(_numArgs),
-    mandatory(_mandatory) {
+    minArgs(_numArgs == INFINITY ? 0 : _numArgs),
+    maxArgs(_numArgs),
+    mandatory(_mandatory),
+    positional(false),
+    duplicatePolicy(REJECT) {
     switch (_type) {
     case SHORT:
         shortArg = _arg;
@@ -71,27 +93,30 @@ Argument::Argument(const string& _arg, const string& _desc, Type _type,
     case LONG:
         longArg = _arg;
         break;
+    case POSITIONAL:
+        // the name is kept as the long argument so that the values are
+        // stored under it
+        longArg = _arg;
+        positional = true;
+        break;
     }
-    validator = _validator;
+    setValidator(unownedValidator(_validator));
 }
 
 Argument::~Argument() {}
 
-string Argument::getArg() const {
+const string& Argument::getArg() const {
     if (!shortArg.empty()) {
         return shortArg;
     }
-    if (!longArg.empty()) {
-        return longArg;
-    }
-    return "";
+    return longArg;
 }
 
-string Argument::getShortArg() const {
+const string& Argument::getShortArg() const {
     return shortArg;
 }
 
-string Argument::getLongArg() const {
+const string& Argument::getLongArg() const {
     return longArg;
 }
 
@@ -100,10 +125,14 @@ bool Argument::isShortArg() const {
 }
 
 bool Argument::isLongArg() const {
-    return (longArg.size() > 0) ? true : false;
+    return (longArg.size() > 0 && !positional) ? true : false;
+}
+
+bool Argument::isPositional() const {
+    return positional;
 }
 
-string Argument::getDescription() const {
+const string& Argument::getDescription() const {
     return description;
 }
 
@@ -111,12 +140,47 @@ int Argument::getNumArgs() const {
     return numArgs;
 }
 
+Argument& Argument::setNumArgs(int _minArgs, int _maxArgs) {
+    if (_minArgs < 0 || (_maxArgs != INFINITY && _maxArgs < _minArgs)) {
+        throw InvalidArgumentException(getArg() + " can't take " +
+            cppargparser::toString(_minArgs) + " to " +
+            (_maxArgs == INFINITY ? string("infinity") : cppargparser::toString(_maxArgs)) +
+            " argument(s)");
+    }
+    minArgs = _minArgs;
+    maxArgs = _maxArgs;
+    numArgs = (_minArgs == _maxArgs) ? _minArgs : INFINITY;
+    return *this;
+}
+
+int Argument::getMinArgs() const {
+    return minArgs;
+}
+
+int Argument::getMaxArgs() const {
+    return maxArgs;
+}
+
 bool Argument::isMandatory() const {
     return mandatory;
 }
 
-Validator* Argument::getValidator() {
-    return validator;
+const Validator* Argument::getValidator() const {
+    return validator.get();
+}
+
+Argument& Argument::setValidator(shared_ptr<const Validator> _validator) {
+    validator = std::move(_validator);
+    return *this;
+}
+
+Argument& Argument::setDuplicatePolicy(DuplicatePolicy policy) {
+    duplicatePolicy = policy;
+    return *this;
+}
+
+Argument::DuplicatePolicy Argument::getDuplicatePolicy() const {
+    return duplicatePolicy;
 }
 
 }
@@ -13,148 +13,965 @@
 // You should have received a copy of the Lesser GNU General Public License
 // along with this program. If not, see <http://www.gnu.org/licenses/>
 
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <exception>
+#include <future>
 #include <iostream>
+#include <list>
+#include <memory>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <utility>
 #include "ArgumentParser.h"
+#include "ConfigFile.h"
 #include "InvalidArgumentException.h"
 #include "ArgumentParserUtils.h"
 
+#ifdef _WIN32
+#define environ _environ
+#else
+extern "C" char** environ;
+#endif
+
 using namespace std;
 
 namespace cppargparser {
 
+namespace {
+
+const int NO_ARGUMENT = -1;
+// the position of an argument that isn't in the command line
+const size_t NOT_PARSED = static_cast<size_t>(-1);
+
+// takes a copy of the environment variables starting with PREFIX_ so that
+// the environment is scanned only once instead of calling getenv for every
+// argument
+typedef pmr::unordered_map<pmr::string, pmr::string> Environment;
+
+void snapshotEnvironment(const string& prefix, Environment& env) {
+    for (char** e = environ; e != NULL && *e != NULL; ++e) {
+        const char* s = *e;
+        if (strncmp(s, prefix.c_str(), prefix.size()) != 0 ||
+            s[prefix.size()] != '_') {
+            continue;
+        }
+        const char* eq = strchr(s, '=');
+        if (eq != NULL) {
+            env.emplace(string_view(s, eq - s), string_view(eq + 1));
+        }
+    }
+}
+
+bool equalsIgnoreCase(string_view a, const char* b) {
+    size_t i = 0;
+    for (; i < a.size() && b[i] != '\0'; ++i) {
+        if (tolower(static_cast<unsigned char>(a[i])) != b[i]) {
+            return false;
+        }
+    }
+    return i == a.size() && b[i] == '\0';
+}
+
+// parses the value of a flag from the environment or a configuration file,
+// an empty value is the same as not setting the flag
+bool parseFlag(string_view value, string_view name) {
+    static const char* const ON[] = { "true", "yes", "on", "1" };
+    static const char* const OFF[] = { "false", "no", "off", "0" };
+    if (value.empty()) {
+        return false;
+    }
+    for (size_t i = 0; i < sizeof(ON) / sizeof(ON[0]); ++i) {
+        if (equalsIgnoreCase(value, ON[i])) {
+            return true;
+        }
+        if (equalsIgnoreCase(value, OFF[i])) {
+            return false;
+        }
+    }
+    throw InvalidArgumentException(string(name) + " is an invalid flag value");
+}
+
+// splits a value from the environment or a configuration file by white
+// space into the values of an argument
+void splitValues(string_view s, pmr::vector<pmr::string>& values) {
+    size_t end = 0;
+    while (true) {
+        size_t begin = s.find_first_not_of(" \t\n\r\f\v", end);
+        if (begin == string_view::npos) {
+            return;
+        }
+        end = s.find_first_of(" \t\n\r\f\v", begin);
+        values.emplace_back(s.substr(begin, end == string_view::npos ?
+            string_view::npos : end - begin));
+        if (end == string_view::npos) {
+            return;
+        }
+    }
+}
+
+pmr::string toEnvironmentName(const string& prefix, string_view name,
+    pmr::memory_resource* resource) {
+    pmr::string envName(prefix, resource);
+    envName += '_';
+    size_t i = name.find_first_not_of('-');
+    for (; i < name.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(name[i]);
+        envName += isalnum(c) ? static_cast<char>(toupper(c)) : '_';
+    }
+    return envName;
+}
+
+// the number of values an argument requires, e.g. "2", "2 to 5" or
+// "at least 1"
+string toArity(int minArgs, int maxArgs) {
+    if (maxArgs == Argument::INFINITY) {
+        return "at least " + cppargparser::toString(minArgs);
+    }
+    if (minArgs != maxArgs) {
+        return cppargparser::toString(minArgs) + " to " +
+            cppargparser::toString(maxArgs);
+    }
+    return cppargparser::toString(minArgs);
+}
+
+// joins the started threads when it goes out of scope, so that an exception
+// never destroys a joinable std::thread
+class ThreadJoiner {
+public:
+    explicit ThreadJoiner(vector<thread>& _threads) : threads(_threads) {}
+
+    ~ThreadJoiner() {
+        for (size_t i = 0; i < threads.size(); ++i) {
+            if (threads[i].joinable()) {
+                threads[i].join();
+            }
+        }
+    }
+
+private:
+    vector<thread>& threads;
+};
+
+// the bitsets of the argument indexes, e.g. the seen arguments and the
+// constraint masks
+const size_t WORD_BITS = 64;
+
+template <typename Bits>
+bool testBit(const Bits& bits, size_t i) {
+    return i / WORD_BITS < bits.size() && ((bits[i / WORD_BITS] >> (i % WORD_BITS)) & 1) != 0;
+}
+
+template <typename Bits>
+void setBit(Bits& bits, size_t i) {
+    if (bits.size() <= i / WORD_BITS) {
+        bits.resize(i / WORD_BITS + 1, 0);
+    }
+    bits[i / WORD_BITS] |= static_cast<uint64_t>(1) << (i % WORD_BITS);
+}
+
+// the lowest index in mask that is or isn't set in bits, NO_ARGUMENT if none
+template <typename Bits>
+int findInMask(const Bits& bits, const vector<uint64_t>& mask, bool set) {
+    for (size_t w = 0; w < mask.size(); ++w) {
+        uint64_t word = (w < bits.size()) ? bits[w] : 0;
+        uint64_t found = mask[w] & (set ? word : ~word);
+        if (found != 0) {
+            size_t bit = 0;
+            while (((found >> bit) & 1) == 0) {
+                ++bit;
+            }
+            return static_cast<int>(w * WORD_BITS + bit);
+        }
+    }
+    return NO_ARGUMENT;
+}
+
+template <typename Bits>
+size_t countInMask(const Bits& bits, const vector<uint64_t>& mask) {
+    size_t n = 0;
+    for (size_t w = 0; w < mask.size() && w < bits.size(); ++w) {
+        n += bitset<WORD_BITS>(mask[w] & bits[w]).count();
+    }
+    return n;
+}
+
+// stores the k-th value of an argument, overwriting the existing one if any
+void storeValue(pmr::vector<pmr::string>& values, size_t k, pmr::string&& value) {
+    if (k < values.size()) {
+        values[k] = std::move(value);
+    } else {
+        values.push_back(std::move(value));
+    }
+}
+
+// replaces the token at i with the tokens and moves i to the first of them.
+// The tokens before i are already consumed, so their slots are reused rather
+// than shifting all the tokens after i, which would make splitting many
+// tokens quadratic
+void replaceToken(pmr::vector<pmr::string>& v, size_t start, size_t& i,
+    pmr::vector<pmr::string>& tokens) {
+    size_t extra = tokens.size() - 1;
+    if (i - start >= extra) {
+        i -= extra;
+        move(tokens.begin(), tokens.end(), v.begin() + i);
+    } else {
+        v[i] = std::move(tokens[0]);
+        v.insert(v.begin() + i + 1, make_move_iterator(tokens.begin() + 1),
+            make_move_iterator(tokens.end()));
+    }
+}
+
+}
+
+ArgumentParser::ArgumentParser() :
+    allowAbbreviation(false),
+    validationThreads(0),
+    positionalTail(NO_ARGUMENT),
+    helpRendered(false) {
+    fill(shortArgs, shortArgs + 256, NO_ARGUMENT);
+}
+
 ArgumentParser::~ArgumentParser() {}
 
 void ArgumentParser::addArgument(const Argument& arg) {
-    vargs.push_back(arg);
+    // a positional argument without values would never get a token
+    if (arg.isPositional() && arg.getNumArgs() == 0) {
+        throw InvalidArgumentException(arg.getArg() +
+            " is an invalid argument, a positional argument must take values");
+    }
+    if (arg.isPositional() && positionalTail != NO_ARGUMENT) {
+        throw InvalidArgumentException(arg.getArg() +
+            " is an invalid argument, it is after " +
+            string(getArg(vargs[positionalTail])) +
+            " that takes a variable number of values");
+    }
+    helpRendered = false;
+    int id = static_cast<int>(vargs.size());
+    StoredArgument stored;
+    stored.shortArg = strings.intern(arg.shortArg);
+    stored.longArg = strings.intern(arg.longArg);
+    stored.description = strings.intern(arg.description);
+    stored.numArgs = arg.numArgs;
+    stored.minArgs = arg.minArgs;
+    stored.maxArgs = arg.maxArgs;
+    stored.mandatory = arg.mandatory;
+    stored.positional = arg.positional;
+    stored.duplicatePolicy = arg.duplicatePolicy;
+    stored.validator = arg.validator;
+    vargs.push_back(stored);
+    if (arg.isMandatory()) {
+        setBit(mandatoryArgs, id);
+    }
+    if (arg.isPositional()) {
+        // the slots are laid out here so that parse assigns each positional
+        // token with a single lookup
+        if (arg.getNumArgs() == Argument::INFINITY) {
+            positionalTail = id;
+        } else {
+            positionalSlots.insert(positionalSlots.end(), arg.getNumArgs(), id);
+        }
+        return;
+    }
     if (arg.getShortArg().size() > 0) {
-        args.insert(pair<string, Argument>(arg.getShortArg(), arg));
+        addName(stored.shortArg, id);
     }
 
     if (arg.getLongArg().size() > 0) {
-        args.insert(pair<string, Argument>(arg.getLongArg(), arg));
+        addName(stored.longArg, id);
+        longArgs.add(arg.getLongArg(), id);
+    }
+}
+
+string_view ArgumentParser::getArg(const StoredArgument& argument) const {
+    string_view shortArg = strings.get(argument.shortArg);
+    return shortArg.empty() ? strings.get(argument.longArg) : shortArg;
+}
+
+void ArgumentParser::addName(uint32_t stringId, int id) {
+    string_view name = strings.get(stringId);
+    if (stringId >= args.size()) {
+        args.resize(stringId + 1, NO_ARGUMENT);
+    }
+    if (args[stringId] != NO_ARGUMENT) {
+        return;
+    }
+    args[stringId] = id;
+    // single character short arguments, e.g. -v, are also looked up
+    // directly by their character
+    if (name.size() == 2 && name[0] == '-' && name[1] != '-') {
+        shortArgs[static_cast<unsigned char>(name[1])] = id;
+    }
+}
+
+int ArgumentParser::findArgument(string_view arg) const {
+    if (arg.size() == 2 && arg[0] == '-') {
+        return shortArgs[static_cast<unsigned char>(arg[1])];
+    }
+    uint32_t stringId = strings.find(arg);
+    return (stringId < args.size()) ? args[stringId] : NO_ARGUMENT;
+}
+
+int ArgumentParser::findSubcommand(string_view name) const {
+    uint32_t stringId = strings.find(name);
+    return (stringId < subcommands.size()) ? subcommands[stringId] : NO_ARGUMENT;
+}
+
+int ArgumentParser::findDeclaredArgument(const string& arg) const {
+    int id = findArgument(arg);
+    for (size_t i = 0; id == NO_ARGUMENT && i < vargs.size(); ++i) {
+        if (vargs[i].positional && strings.get(vargs[i].longArg) == arg) {
+            id = static_cast<int>(i);
+        }
+    }
+    if (id == NO_ARGUMENT) {
+        throw InvalidArgumentException(arg + " is an invalid argument");
+    }
+    return id;
+}
+
+void ArgumentParser::addRequires(const string& arg, const string& required) {
+    Constraint constraint;
+    constraint.type = Constraint::REQUIRES;
+    constraint.id = findDeclaredArgument(arg);
+    setBit(constraint.mask, findDeclaredArgument(required));
+    constraints.push_back(constraint);
+}
+
+void ArgumentParser::addExcludes(const string& arg, const string& excluded) {
+    Constraint constraint;
+    constraint.type = Constraint::EXCLUDES;
+    constraint.id = findDeclaredArgument(arg);
+    setBit(constraint.mask, findDeclaredArgument(excluded));
+    constraints.push_back(constraint);
+}
+
+void ArgumentParser::addExactlyOne(const vector<string>& group) {
+    Constraint constraint;
+    constraint.type = Constraint::EXACTLY_ONE;
+    constraint.id = NO_ARGUMENT;
+    for (vector<string>::const_iterator i = group.begin(); i != group.end(); ++i) {
+        setBit(constraint.mask, findDeclaredArgument(*i));
+    }
+    constraints.push_back(constraint);
+}
+
+void ArgumentParser::checkConstraints(const Seen& seen) const {
+    // each check is a single pass over the words of a mask
+    int missing = findInMask(seen, mandatoryArgs, false);
+    if (missing != NO_ARGUMENT) {
+        throw InvalidArgumentException(string(getArg(vargs[missing])) +
+            " is a mandatory argument");
+    }
+    for (vector<Constraint>::const_iterator i = constraints.begin();
+        i != constraints.end(); ++i) {
+        switch (i->type) {
+        case Constraint::REQUIRES:
+            if (testBit(seen, i->id)) {
+                missing = findInMask(seen, i->mask, false);
+                if (missing != NO_ARGUMENT) {
+                    throw InvalidArgumentException(string(getArg(vargs[i->id])) +
+                        " requires " + string(getArg(vargs[missing])));
+                }
+            }
+            break;
+        case Constraint::EXCLUDES:
+            if (testBit(seen, i->id)) {
+                int excluded = findInMask(seen, i->mask, true);
+                if (excluded != NO_ARGUMENT) {
+                    throw InvalidArgumentException(string(getArg(vargs[i->id])) +
+                        " can't be used with " + string(getArg(vargs[excluded])));
+                }
+            }
+            break;
+        case Constraint::EXACTLY_ONE:
+            if (countInMask(seen, i->mask) != 1) {
+                vector<string> names;
+                for (size_t id = 0; id < vargs.size(); ++id) {
+                    if (testBit(i->mask, id)) {
+                        names.push_back(string(getArg(vargs[id])));
+                    }
+                }
+                throw InvalidArgumentException("exactly one of " +
+                    cppargparser::toString(names) + " is required");
+            }
+            break;
+        }
+    }
+}
+
+bool ArgumentParser::expandShortArgs(Tokens& v, size_t start, size_t& i) const {
+    // expands bundled short arguments, e.g. -xzf into -x -z -f, where the
+    // rest of the token after an argument that needs values is its first
+    // value, e.g. -ofile into -o file
+    const pmr::string& s = v[i];
+    Tokens tokens(v.get_allocator());
+    for (size_t k = 1; k < s.size(); ++k) {
+        int id = shortArgs[static_cast<unsigned char>(s[k])];
+        if (id == NO_ARGUMENT) {
+            return false;
+        }
+        tokens.emplace_back(1, '-');
+        tokens.back() += s[k];
+        if (vargs[id].numArgs != 0 && k + 1 < s.size()) {
+            tokens.emplace_back(s, k + 1);
+            break;
+        }
+    }
+    replaceToken(v, start, i, tokens);
+    return true;
+}
+
+void ArgumentParser::setAllowAbbreviation(bool allow) {
+    allowAbbreviation = allow;
+}
+
+void ArgumentParser::setEnvironmentPrefix(const string& prefix) {
+    environmentPrefix = prefix;
+}
+
+void ArgumentParser::setValidationThreads(unsigned int threads) {
+    validationThreads = threads;
+}
+
+void ArgumentParser::addConfigFile(const string& path) {
+    configFiles.push_back(path);
+}
+
+void ArgumentParser::addSubcommand(const string& name, const string& desc,
+    const ArgumentParserFactory* factory) {
+    helpRendered = false;
+    Subcommand subcommand;
+    subcommand.name = strings.intern(name);
+    subcommand.description = strings.intern(desc);
+    subcommand.factory = factory;
+    if (subcommand.name >= subcommands.size()) {
+        subcommands.resize(subcommand.name + 1, NO_ARGUMENT);
+    }
+    if (subcommands[subcommand.name] == NO_ARGUMENT) {
+        subcommands[subcommand.name] = static_cast<int>(vsubcommands.size());
     }
+    vsubcommands.push_back(subcommand);
 }
 
 ParsedArgument ArgumentParser::parse(int argc, char** argv) {
+    return parse(argc, argv, pmr::get_default_resource());
+}
+
+ParsedArgument ArgumentParser::parse(int argc, char** argv,
+    pmr::memory_resource* resource) {
     // put all the arguments into vector for easy manipulation
-    vector<string> v;
+    Tokens v(resource);
+    v.reserve(argc);
     for (int i = 1; i < argc; i++) {
-        v.push_back(string(argv[i]));
+        v.emplace_back(argv[i]);
     }
-    ParsedArgument pa;
+    ParsedArgument pa(resource);
     // ignore the first argument since the first argument is a program name
-    for (size_t i = 0; i < v.size(); ++i) {
-        string s = v[i];
-        bool shortArg = cppargparser::isShortArg(s);
-        bool longArg = cppargparser::isLongArg(s);
+    parse(v, 0, pa);
+    return pa;
+}
+
+void ArgumentParser::parse(Tokens& v, size_t start, ParsedArgument& pa) {
+    Seen seen((vargs.size() + WORD_BITS - 1) / WORD_BITS, 0, v.get_allocator());
+    Positions positions(validationThreads > 0 ? vargs.size() : 0, NOT_PARSED,
+        v.get_allocator());
+    size_t order = 0;
+    // the number of positional tokens so far and where the values of the
+    // current positional argument are stored
+    size_t positional = 0;
+    int positionalId = NO_ARGUMENT;
+    size_t positionalIndex = 0;
+    for (size_t i = start; i < v.size(); ++i) {
+        bool shortArg = cppargparser::isShortArg(v[i]);
+        bool longArg = cppargparser::isLongArg(v[i]);
         if (!shortArg && !longArg) {
-            throw InvalidArgumentException(s + " is an invalid argument");
+            int sc = subcommands.empty() ? NO_ARGUMENT : findSubcommand(v[i]);
+            if (sc != NO_ARGUMENT) {
+                // the subcommand parser is only created here, so unused
+                // subcommands never pay for building their arguments
+                const Subcommand& subcommand = vsubcommands[sc];
+                unique_ptr<ArgumentParser> subparser(subcommand.factory->create());
+                pa.setSubcommand(strings.get(subcommand.name));
+                subparser->parse(v, i + 1, pa);
+                break;
+            }
+            int id = (positional < positionalSlots.size()) ?
+                positionalSlots[positional] : positionalTail;
+            if (id == NO_ARGUMENT || (id == positionalTail &&
+                vargs[id].maxArgs != Argument::INFINITY &&
+                positional - positionalSlots.size() >=
+                static_cast<size_t>(vargs[id].maxArgs))) {
+                throw InvalidArgumentException(string(v[i]) + " is an invalid argument");
+            }
+            if (id != positionalId) {
+                positionalId = id;
+                positionalIndex = pa.findOrAdd(strings.get(vargs[id].longArg));
+                pa.counts[positionalIndex] = 1;
+                setBit(seen, id);
+                if (!positions.empty()) {
+                    positions[id] = order++;
+                }
+            }
+            pa.values[positionalIndex].push_back(std::move(v[i]));
+            ++positional;
+            continue;
         }
-        string arg = s;
         if (longArg) {
             // if the argument has =, e.g. ---ccc=123 split it by = and then
             // modify the vector by modifying --ccc=123 with --ccc and adding
             // a new element 123
-            size_t index = arg.find("=");
+            size_t index = v[i].find('=');
             if (index != string::npos) {
-                string key = arg.substr(0, index);
-                string value = arg.substr(index+1);
-                arg = key;
-                v[i] = key;
-                v.insert(v.begin()+i+1, value);
-            }
-        }
-        map<string, Argument>::iterator it = args.find(arg);
-        if (it == args.end()) {
-            throw InvalidArgumentException(arg + " is an invalid argument");
-        }
-        Argument argument = it->second;
-        if (argument.getNumArgs() == Argument::INFINITY) {
-            string value = "";
-            do {
-                value = v[++i];
-                if (!cppargparser::isShortArg(value)) {
-                    pa.putArgument(argument.getShortArg(), value);
-                }
-                if (!cppargparser::isLongArg(value)) {
-                    pa.putArgument(argument.getLongArg(), value);
+                Tokens tokens(v.get_allocator());
+                tokens.reserve(2);
+                tokens.emplace_back(v[i], 0, index);
+                tokens.emplace_back(v[i], index + 1);
+                replaceToken(v, start, i, tokens);
+            }
+        }
+        int id = findArgument(v[i]);
+        // an abbreviation needs a character after the dashes, otherwise an
+        // empty name like the one of --=x would be a prefix of every long
+        // argument
+        if (id == NO_ARGUMENT && longArg && allowAbbreviation && v[i].size() > 2) {
+            id = longArgs.find(v[i]);
+            if (id == LongArgumentIndex::AMBIGUOUS) {
+                throw InvalidArgumentException(string(v[i]) + " is an ambiguous argument");
+            }
+        }
+        if (id == NO_ARGUMENT && !longArg && expandShortArgs(v, start, i)) {
+            id = findArgument(v[i]);
+        }
+        if (id == NO_ARGUMENT) {
+            throw InvalidArgumentException(string(v[i]) + " is an invalid argument");
+        }
+        const StoredArgument& argument = vargs[id];
+        Argument::DuplicatePolicy policy = argument.duplicatePolicy;
+        bool repeated = testBit(seen, id);
+        if (repeated && policy == Argument::REJECT) {
+            throw InvalidArgumentException(string(v[i]) + " is a duplicate argument");
+        }
+        setBit(seen, id);
+        if (!repeated && !positions.empty()) {
+            positions[id] = order++;
+        }
+        // the values are stored once for both the short and the long
+        // argument and moved out of the tokens
+        size_t index = pa.findOrAdd(strings.get(argument.shortArg),
+            strings.get(argument.longArg));
+        ParsedArgument::Values& values = pa.values[index];
+        ++pa.counts[index];
+        // the values of a repeated argument are still consumed, but they are
+        // only stored for LAST_WINS and APPEND. LAST_WINS overwrites the
+        // previous values in place so that their storage gets reused
+        bool store = !repeated || policy == Argument::LAST_WINS ||
+            policy == Argument::APPEND;
+        size_t k = (repeated && policy == Argument::LAST_WINS) ? 0 : values.size();
+        if (argument.numArgs == Argument::INFINITY) {
+            // find the whole run of values in a single scan, it stops at the
+            // next option, at the end of the tokens or at the maximum number
+            // of values
+            size_t first = i + 1;
+            size_t last = first;
+            size_t end = v.size();
+            if (argument.maxArgs != Argument::INFINITY) {
+                end = min(end, first + argument.maxArgs);
+            }
+            while (last < end && !cppargparser::isOption(v[last])) {
+                ++last;
+            }
+            if (last - first < static_cast<size_t>(argument.minArgs)) {
+                throw InvalidArgumentException(string(getArg(argument)) + " requires " +
+                    toArity(argument.minArgs, argument.maxArgs) + " argument(s)");
+            }
+            if (store) {
+                Tokens::iterator b = v.begin() + first;
+                Tokens::iterator e = v.begin() + last;
+                if (k < values.size()) {
+                    values.assign(make_move_iterator(b), make_move_iterator(e));
+                } else {
+                    values.insert(values.end(), make_move_iterator(b),
+                        make_move_iterator(e));
                 }
-            } while (!isShortArg(value) && !isLongArg(value));
+                k = values.size();
+            }
+            i = last;
         } else {
             i = i + 1;
-            size_t n = i + argument.getNumArgs();
+            size_t n = i + argument.numArgs;
             // this condition means there's the argument doesn't need any value,
             // i.e. the numArgs is 0, thus there's no need to iterate each
             // argument value
             if (i == n) {
-                pa.putArgument(argument.getShortArg(), "");
-                pa.putArgument(argument.getLongArg(), "");
+                // flags only keep a count, see ParsedArgument::getCount
+                pa.flags[index] = true;
             }
             else {
+                // APPEND grows the values geometrically, reserving the exact
+                // size for every repetition would copy them all each time
+                if (store && k == 0) {
+                    values.reserve(argument.numArgs);
+                }
                 for (; i < n; ++i) {
                     if (i >= v.size()) {
                         throw InvalidArgumentException(
-                            argument.getArg() + " requires " +
-                            cppargparser::toString(argument.getNumArgs()) +
+                            string(getArg(argument)) + " requires " +
+                            cppargparser::toString(argument.numArgs) +
                             " argument(s)");
                     }
-                    string value = v[i];
-                    pa.putArgument(argument.getShortArg(), value);
-                    pa.putArgument(argument.getLongArg(), value);
+                    if (store) {
+                        storeValue(values, k++, std::move(v[i]));
+                    }
                 }
             }
         }
-        Validator* validator = argument.getValidator();
-        if (validator != NULL) {
-            if (argument.isShortArg()) {
-                vector<string> values = pa.getValues(argument.getShortArg());
-                if (!validator->validate(values)) {
-                    throw InvalidArgumentException(cppargparser::toString(values) +
-                        " is an invalid argument value");
-                }
-            } else {
-                vector<string> values = pa.getValues(argument.getLongArg());
-                if (!validator->validate(values)) {
-                    throw InvalidArgumentException(cppargparser::toString(values) +
-                        " is an invalid argument value");
-                }
+        if (store) {
+            values.resize(k);
+            if (validationThreads == 0) {
+                validate(argument, pa);
             }
         }
-        args.erase(argument.getShortArg());
-        args.erase(argument.getLongArg());
         // need to decrement i here because both inner and outer loops
         // increment i by 1
         --i;
     }
-    // check if the there are still mandatory arguments in the args map
-    // if there are, throw an InvalidArgumentException
-    for (map<string, Argument>::const_iterator i = args.begin(); i != args.end(); ++i) {
-        if (i->second.isMandatory()) {
-            throw InvalidArgumentException(i->second.getArg() +
-                " is a mandatory argument");
+    // the positional arguments are only complete after all the tokens
+    for (size_t i = 0; i < vargs.size(); ++i) {
+        if (!testBit(seen, i) || !vargs[i].positional) {
+            continue;
         }
+        const StoredArgument& argument = vargs[i];
+        if (pa.find(strings.get(argument.longArg)).size() <
+            static_cast<size_t>(argument.minArgs)) {
+            throw InvalidArgumentException(string(getArg(argument)) + " requires " +
+                toArity(argument.minArgs, argument.maxArgs) + " argument(s)");
+        }
+        if (validationThreads == 0) {
+            validate(argument, pa);
+        }
+    }
+    if (!environmentPrefix.empty()) {
+        parseEnvironment(seen, pa);
+    }
+    if (!configFiles.empty()) {
+        parseConfigFiles(seen, pa);
     }
+    if (validationThreads > 0) {
+        validateDeferred(seen, positions, pa);
+    }
+    checkConstraints(seen);
+}
 
-    return pa;
+void ArgumentParser::parseEnvironment(Seen& seen, ParsedArgument& pa) const {
+    pmr::memory_resource* resource = pa.getMemoryResource();
+    Environment env(resource);
+    snapshotEnvironment(environmentPrefix, env);
+    if (env.empty()) {
+        return;
+    }
+    Tokens values(resource);
+    for (size_t i = 0; i < vargs.size(); ++i) {
+        if (testBit(seen, i)) {
+            continue;
+        }
+        const StoredArgument& argument = vargs[i];
+        string_view longArg = strings.get(argument.longArg);
+        Environment::const_iterator it = env.find(toEnvironmentName(environmentPrefix,
+            longArg.empty() ? strings.get(argument.shortArg) : longArg, resource));
+        if (it == env.end()) {
+            continue;
+        }
+        values.clear();
+        if (argument.numArgs == 0) {
+            if (!parseFlag(it->second, it->first)) {
+                continue;
+            }
+        } else if (argument.numArgs == 1) {
+            values.push_back(it->second);
+        } else {
+            splitValues(it->second, values);
+        }
+        putValues(argument, values, ParsedArgument::ENVIRONMENT, it->first, pa);
+        setBit(seen, i);
+    }
+}
+
+void ArgumentParser::parseConfigFiles(Seen& seen, ParsedArgument& pa) const {
+    pmr::memory_resource* resource = pa.getMemoryResource();
+    // the keys are the argument names without the leading dashes, they
+    // point into strings
+    pmr::unordered_map<string_view, int> names(resource);
+    for (size_t i = 0; i < vargs.size(); ++i) {
+        if (!testBit(seen, i)) {
+            string_view name = strings.get(vargs[i].longArg);
+            if (name.empty()) {
+                name = strings.get(vargs[i].shortArg);
+            }
+            size_t start = name.find_first_not_of('-');
+            names.insert(make_pair(start == string_view::npos ? string_view() :
+                name.substr(start), static_cast<int>(i)));
+        }
+    }
+    // the files stay mapped until all the values are copied, the entries of
+    // a later file or a later line replace the earlier ones
+    pmr::list<ConfigFile> files(resource);
+    pmr::vector<const ConfigFile::Entry*> entries(vargs.size(), NULL, resource);
+    pmr::vector<size_t> entryFiles(vargs.size(), 0, resource);
+    pmr::string key(resource);
+    for (size_t f = 0; f < configFiles.size(); ++f) {
+        files.emplace_back(configFiles[f], resource);
+        const pmr::vector<ConfigFile::Entry>& fileEntries = files.back().getEntries();
+        for (size_t i = 0; i < fileEntries.size(); ++i) {
+            ConfigFile::getKey(fileEntries[i], key);
+            pmr::unordered_map<string_view, int>::const_iterator it = names.find(key);
+            if (it != names.end()) {
+                entries[it->second] = &fileEntries[i];
+                entryFiles[it->second] = f;
+            }
+        }
+    }
+    pmr::string name(resource);
+    Tokens values(resource);
+    Tokens split(resource);
+    for (size_t i = 0; i < vargs.size(); ++i) {
+        if (entries[i] == NULL) {
+            continue;
+        }
+        const StoredArgument& argument = vargs[i];
+        ConfigFile::getKey(*entries[i], key);
+        char line[16];
+        to_chars_result end = to_chars(line, line + sizeof(line), entries[i]->line);
+        name = configFiles[entryFiles[i]];
+        name += ':';
+        name.append(line, end.ptr);
+        name += ' ';
+        name += key;
+        values.clear();
+        ConfigFile::getValues(*entries[i], values);
+        if (argument.numArgs == 0) {
+            if (!parseFlag(values.empty() ? string_view() : string_view(values[0]), name)) {
+                continue;
+            }
+            values.clear();
+        } else if (values.size() == 1 && argument.numArgs != 1) {
+            split.clear();
+            splitValues(values[0], split);
+            values.swap(split);
+        }
+        putValues(argument, values, ParsedArgument::CONFIG_FILE, name, pa);
+        setBit(seen, i);
+    }
+}
+
+void ArgumentParser::putValues(const StoredArgument& argument, Tokens& values,
+    ParsedArgument::Source source, string_view name, ParsedArgument& pa) const {
+    if (argument.numArgs != 0 &&
+        (values.size() < static_cast<size_t>(argument.minArgs) ||
+        (argument.maxArgs != Argument::INFINITY &&
+        values.size() > static_cast<size_t>(argument.maxArgs)))) {
+        throw InvalidArgumentException(string(name) + " requires " +
+            toArity(argument.minArgs, argument.maxArgs) + " argument(s)");
+    }
+    size_t index = pa.findOrAdd(strings.get(argument.shortArg),
+            strings.get(argument.longArg));
+    if (argument.numArgs == 0) {
+        pa.flags[index] = true;
+    } else {
+        pa.values[index].insert(pa.values[index].end(), make_move_iterator(values.begin()),
+            make_move_iterator(values.end()));
+    }
+    pa.sources[index] = source;
+    pa.counts[index] = 1;
+    if (validationThreads == 0) {
+        validate(argument, pa);
+    }
+}
+
+void ArgumentParser::validateDeferred(const Seen& seen, const Positions& positions,
+    const ParsedArgument& pa) const {
+    // the arguments from the environment and the configuration files have
+    // no position and go last, in the order they were added
+    vector<pair<size_t, int> > tasks;
+    for (size_t i = 0; i < vargs.size(); ++i) {
+        if (testBit(seen, i) && vargs[i].validator) {
+            tasks.push_back(make_pair(positions[i], static_cast<int>(i)));
+        }
+    }
+    sort(tasks.begin(), tasks.end());
+
+    // the threads start the next validation until there are none left, a
+    // validator that isn't asynchronous is done by the time it's started.
+    // The results are kept by task so they can be reported in the command
+    // line order
+    vector<future<bool> > results(tasks.size());
+    vector<exception_ptr> errors(tasks.size());
+    atomic<size_t> next(0);
+    auto work = [&]() {
+        for (size_t t = next.fetch_add(1); t < tasks.size(); t = next.fetch_add(1)) {
+            const StoredArgument& argument = vargs[tasks[t].second];
+            try {
+                results[t] = argument.validator->validateAsync(
+                    ValueList(pa.find(getArg(argument))));
+            } catch (...) {
+                errors[t] = current_exception();
+            }
+        }
+    };
+    vector<thread> threads;
+    size_t numThreads = min(static_cast<size_t>(validationThreads), tasks.size());
+    threads.reserve(numThreads);
+    {
+        ThreadJoiner joiner(threads);
+        for (size_t i = 1; i < numThreads; ++i) {
+            try {
+                threads.emplace_back(work);
+            } catch (const system_error&) {
+                // the threads already started and this one do the rest
+                break;
+            }
+        }
+        work();
+    }
+
+    // all the validations are started, now wait for all of them before
+    // reporting any error
+    string message;
+    size_t failures = 0;
+    exception_ptr other;
+    for (size_t t = 0; t < errors.size(); ++t) {
+        string error;
+        try {
+            if (errors[t]) {
+                rethrow_exception(errors[t]);
+            }
+            if (results[t].get()) {
+                continue;
+            }
+            error = cppargparser::toString(ValueList(pa.find(
+                getArg(vargs[tasks[t].second])))) + " is an invalid argument value";
+        } catch (const InvalidArgumentException& e) {
+            error = e.what();
+        } catch (const exception& e) {
+            error = e.what();
+            if (!other) {
+                other = current_exception();
+            }
+        } catch (...) {
+            error = "unknown error";
+            if (!other) {
+                other = current_exception();
+            }
+        }
+        if (!message.empty()) {
+            message += '\n';
+        }
+        message += error;
+        ++failures;
+    }
+    // an error that isn't an InvalidArgumentException is rethrown as is
+    // when it's the only one, otherwise its message is reported with the
+    // other errors
+    if (other && failures == 1) {
+        rethrow_exception(other);
+    }
+    if (failures > 0) {
+        throw InvalidArgumentException(message);
+    }
+}
+
+void ArgumentParser::validate(const StoredArgument& argument,
+    const ParsedArgument& pa) const {
+    const Validator* validator = argument.validator.get();
+    if (validator != NULL) {
+        // the values are only copied for the error message
+        ValueList values(pa.find(getArg(argument)));
+        if (!validator->validate(values)) {
+            throw InvalidArgumentException(cppargparser::toString(values) +
+                " is an invalid argument value");
+        }
+    }
 }
 
 void ArgumentParser::showHelp(const string& programName) const {
-    cout << "Usage: " << programName << endl;
-    cout << "Options:" << endl;
-    for (vector<Argument>::const_iterator i = vargs.begin(); i != vargs.end(); ++i) {
-        string options = "";
-        if (i->isShortArg()) {
-            options += i->getShortArg();
-            if (i->isLongArg()) {
-                options += ", ";
+    const string& text = getHelp(programName);
+    cout.write(text.data(), text.size());
+    cout.flush();
+}
+
+const string& ArgumentParser::getHelp(const string& programName) const {
+    if (!helpRendered || helpProgramName != programName) {
+        renderHelp(programName);
+    }
+    return help;
+}
+
+void ArgumentParser::renderHelp(const string& programName) const {
+    // build the options column first so that the description column can be
+    // aligned based on the longest option instead of a fixed width
+    vector<string> options;
+    options.reserve(vargs.size());
+    size_t width = 0;
+    size_t descSize = 0;
+    for (vector<StoredArgument>::const_iterator i = vargs.begin(); i != vargs.end(); ++i) {
+        string_view shortArg = strings.get(i->shortArg);
+        string_view longArg = strings.get(i->longArg);
+        string option = "";
+        if (!shortArg.empty()) {
+            option += shortArg;
+            if (!longArg.empty() && !i->positional) {
+                option += ", ";
             }
         }
-        if (i->isLongArg()) {
-            options += i->getLongArg();
+        option += longArg;
+        if (option.size() > width) {
+            width = option.size();
+        }
+        descSize += strings.get(i->description).size();
+        options.push_back(option);
+    }
+    for (vector<Subcommand>::const_iterator i = vsubcommands.begin();
+        i != vsubcommands.end(); ++i) {
+        if (strings.get(i->name).size() > width) {
+            width = strings.get(i->name).size();
+        }
+        descSize += strings.get(i->description).size();
+    }
+    const size_t indent = 4;
+    const size_t gap = 4;
+    width += gap;
+
+    help.clear();
+    help.reserve(programName.size() + 27 + descSize +
+        (vargs.size() + vsubcommands.size()) * (indent + width + 1));
+    help += "Usage: ";
+    help += programName;
+    help += "\nOptions:\n";
+    for (size_t i = 0; i < vargs.size(); ++i) {
+        help.append(indent, ' ');
+        help += options[i];
+        help.append(width - options[i].size(), ' ');
+        help += strings.get(vargs[i].description);
+        help += '\n';
+    }
+    if (!vsubcommands.empty()) {
+        help += "Commands:\n";
+        for (size_t i = 0; i < vsubcommands.size(); ++i) {
+            help.append(indent, ' ');
+            string_view name = strings.get(vsubcommands[i].name);
+            help += name;
+            help.append(width - name.size(), ' ');
+            help += strings.get(vsubcommands[i].description);
+            help += '\n';
         }
-        cout << string(4, ' ') << options << string(40-options.size(), ' ') <<
-            i->getDescription() << endl;
     }
+    helpProgramName = programName;
+    helpRendered = true;
 }
 
 } /* namespace cppargparser */
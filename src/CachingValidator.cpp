@@ -0,0 +1,139 @@
+// Copyright 2012, Fredy Wijaya
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the Lesser GNU General Public License as published by
+// the Free Software Foundation, either version 3.0 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// Lesser GNU General Public License for more details.
+//
+// You should have received a copy of the Lesser GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>
+
+#include <cstring>
+#include <chrono>
+#include "CachingValidator.h"
+
+using namespace std;
+
+namespace cppargparser {
+
+namespace {
+
+const uint64_t VALID = 1;
+
+// seeded FNV-1a followed by the MurmurHash3 finalizer because the slot is
+// picked by the lowest bits
+uint64_t hashBytes(const unsigned char* bytes, size_t length, uint64_t seed) {
+    uint64_t h = 14695981039346656037ULL ^ seed;
+    for (size_t i = 0; i < length; ++i) {
+        h = (h ^ bytes[i]) * 1099511628211ULL;
+    }
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+}
+
+const size_t CachingValidator::DEFAULT_SIZE;
+const size_t CachingValidator::MAX_CACHED_LENGTH;
+const size_t CachingValidator::WORDS;
+
+CachingValidator::CachingValidator(const Validator* _validator, size_t size) :
+    validator(unownedValidator(_validator)) {
+    init(size);
+}
+
+CachingValidator::CachingValidator(shared_ptr<const Validator> _validator, size_t size) :
+    validator(std::move(_validator)) {
+    init(size);
+}
+
+void CachingValidator::init(size_t size) {
+    size_t n = 1;
+    while (n < size) {
+        n <<= 1;
+    }
+    mask = n - 1;
+    // a seed that differs between instances and runs keeps crafted values
+    // from sharing a slot; <random> isn't used as its <cmath> defines
+    // INFINITY, which clashes with Argument::INFINITY
+    seed = static_cast<uint64_t>(
+        chrono::high_resolution_clock::now().time_since_epoch().count());
+    seed ^= reinterpret_cast<uintptr_t>(this) * 0x9e3779b97f4a7c15ULL;
+    slots.reset(new Slot[n]);
+    for (size_t i = 0; i < n; ++i) {
+        slots[i].sequence.store(0, memory_order_relaxed);
+        slots[i].header.store(0, memory_order_relaxed);
+        for (size_t w = 0; w < WORDS; ++w) {
+            slots[i].words[w].store(0, memory_order_relaxed);
+        }
+    }
+}
+
+CachingValidator::~CachingValidator() {}
+
+bool CachingValidator::validate(const vector<string>& values) const {
+    return validateValues(values);
+}
+
+bool CachingValidator::validate(const ValueList& values) const {
+    return validateValues(values);
+}
+
+template <typename Values>
+bool CachingValidator::validateValues(const Values& values) const {
+    // the size and bytes of each value, so that e.g. ["ab"] and ["a", "b"]
+    // differ
+    unsigned char bytes[MAX_CACHED_LENGTH];
+    size_t length = 0;
+    for (typename Values::const_iterator i = values.begin(); i != values.end(); ++i) {
+        size_t size = i->size();
+        if (size >= MAX_CACHED_LENGTH - length) {
+            return validator->validate(values);
+        }
+        bytes[length++] = static_cast<unsigned char>(size);
+        memcpy(bytes + length, i->data(), size);
+        length += size;
+    }
+    uint64_t words[WORDS] = {};
+    memcpy(words, bytes, length);
+    size_t used = (length + 7) / 8;
+    uint64_t header = (length + 1) << 1;
+
+    Slot& slot = slots[hashBytes(bytes, length, seed) & mask];
+    uint64_t sequence = slot.sequence.load(memory_order_acquire);
+    if ((sequence & 1) == 0) {
+        uint64_t entry = slot.header.load(memory_order_relaxed);
+        bool same = (entry & ~VALID) == header;
+        for (size_t w = 0; same && w < used; ++w) {
+            same = slot.words[w].load(memory_order_relaxed) == words[w];
+        }
+        // the slot wasn't stored to while it was read
+        atomic_thread_fence(memory_order_acquire);
+        if (same && slot.sequence.load(memory_order_relaxed) == sequence) {
+            return (entry & VALID) != 0;
+        }
+    }
+    bool valid = validator->validate(values);
+    // if another thread is storing into the slot, its result wins
+    if ((sequence & 1) == 0 && slot.sequence.compare_exchange_strong(
+            sequence, sequence + 1, memory_order_relaxed)) {
+        atomic_thread_fence(memory_order_release);
+        slot.header.store(header | (valid ? VALID : 0), memory_order_relaxed);
+        for (size_t w = 0; w < WORDS; ++w) {
+            slot.words[w].store(words[w], memory_order_relaxed);
+        }
+        slot.sequence.store(sequence + 2, memory_order_release);
+    }
+    return valid;
+}
+
+} /* namespace cppargparser */
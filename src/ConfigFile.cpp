@@ -0,0 +1,259 @@
+// Copyright 2012, Fredy Wijaya
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the Lesser GNU General Public License as published by
+// the Free Software Foundation, either version 3.0 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// Lesser GNU General Public License for more details.
+//
+// You should have received a copy of the Lesser GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include "ConfigFile.h"
+#include "InvalidArgumentException.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace cppargparser {
+
+namespace {
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+void trim(const char*& begin, const char*& end) {
+    while (begin < end && isSpace(*begin)) {
+        ++begin;
+    }
+    while (end > begin && isSpace(*(end - 1))) {
+        --end;
+    }
+}
+
+void unquote(const char*& begin, const char*& end) {
+    if (end - begin >= 2 && (*begin == '"' || *begin == '\'') &&
+        *(end - 1) == *begin) {
+        ++begin;
+        --end;
+    }
+}
+
+// finds the end of a value, i.e. the start of a trailing # comment outside
+// of quotes
+const char* findValueEnd(const char* begin, const char* end) {
+    char quote = '\0';
+    for (const char* p = begin; p < end; ++p) {
+        if (quote != '\0') {
+            if (*p == quote) {
+                quote = '\0';
+            }
+        } else if (*p == '"' || *p == '\'') {
+            quote = *p;
+        } else if (*p == '#') {
+            return p;
+        }
+    }
+    return end;
+}
+
+template <typename String>
+void appendKey(const ConfigFile::Entry& entry, String& key) {
+    key.clear();
+    if (entry.sectionSize > 0) {
+        key.append(entry.section, entry.sectionSize);
+        key += '.';
+    }
+    key.append(entry.key, entry.keySize);
+}
+
+template <typename Values>
+void appendValues(const ConfigFile::Entry& entry, Values& values) {
+    const char* begin = entry.value;
+    const char* end = entry.value + entry.valueSize;
+    if (begin == end || *begin != '[' || *(end - 1) != ']') {
+        unquote(begin, end);
+        values.emplace_back(begin, end);
+        return;
+    }
+    ++begin;
+    --end;
+    trim(begin, end);
+    while (begin < end) {
+        // find the next comma outside of quotes
+        const char* p = begin;
+        char quote = '\0';
+        for (; p < end; ++p) {
+            if (quote != '\0') {
+                if (*p == quote) {
+                    quote = '\0';
+                }
+            } else if (*p == '"' || *p == '\'') {
+                quote = *p;
+            } else if (*p == ',') {
+                break;
+            }
+        }
+        const char* b = begin;
+        const char* e = p;
+        trim(b, e);
+        if (b < e) {
+            unquote(b, e);
+            values.emplace_back(b, e);
+        }
+        begin = (p < end) ? p + 1 : end;
+    }
+}
+
+}
+
+ConfigFile::ConfigFile(const string& _path, pmr::memory_resource* resource) :
+    path(_path, resource),
+    open(false),
+    data(NULL),
+    size(0),
+    buffer(resource),
+    entries(resource) {
+#ifdef _WIN32
+    ifstream in(path.c_str(), ios::in | ios::binary);
+    if (!in) {
+        return;
+    }
+    buffer.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    open = true;
+    if (!buffer.empty()) {
+        read(&buffer[0], &buffer[0] + buffer.size());
+    }
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return;
+    }
+    open = true;
+    if (st.st_size > 0) {
+        void* p = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            open = false;
+        } else {
+            data = static_cast<const char*>(p);
+            size = st.st_size;
+        }
+    }
+    close(fd);
+    if (data != NULL) {
+        try {
+            read(data, data + size);
+        } catch (...) {
+            munmap(const_cast<char*>(data), size);
+            throw;
+        }
+    }
+#endif
+}
+
+ConfigFile::~ConfigFile() {
+#ifndef _WIN32
+    if (data != NULL) {
+        munmap(const_cast<char*>(data), size);
+    }
+#endif
+}
+
+void ConfigFile::read(const char* begin, const char* end) {
+    const char* section = NULL;
+    size_t sectionSize = 0;
+    int line = 0;
+    for (const char* p = begin; p < end; ) {
+        ++line;
+        const char* lineEnd = static_cast<const char*>(memchr(p, '\n', end - p));
+        if (lineEnd == NULL) {
+            lineEnd = end;
+        }
+        const char* b = p;
+        const char* e = lineEnd;
+        p = lineEnd + 1;
+        trim(b, e);
+        if (b == e || *b == '#' || *b == ';') {
+            continue;
+        }
+        if (*b == '[' && *(e - 1) == ']') {
+            const char* nameBegin = b + 1;
+            const char* nameEnd = e - 1;
+            trim(nameBegin, nameEnd);
+            section = nameBegin;
+            sectionSize = nameEnd - nameBegin;
+            continue;
+        }
+        const char* eq = static_cast<const char*>(memchr(b, '=', e - b));
+        if (eq == NULL || eq == b) {
+            ostringstream oss;
+            oss << path << ":" << line << " is an invalid line";
+            throw InvalidArgumentException(oss.str());
+        }
+        Entry entry;
+        const char* keyBegin = b;
+        const char* keyEnd = eq;
+        trim(keyBegin, keyEnd);
+        const char* valueBegin = eq + 1;
+        const char* valueEnd = findValueEnd(valueBegin, e);
+        trim(valueBegin, valueEnd);
+        entry.section = section;
+        entry.sectionSize = sectionSize;
+        entry.key = keyBegin;
+        entry.keySize = keyEnd - keyBegin;
+        entry.value = valueBegin;
+        entry.valueSize = valueEnd - valueBegin;
+        entry.line = line;
+        entries.push_back(entry);
+    }
+}
+
+bool ConfigFile::isOpen() const {
+    return open;
+}
+
+string ConfigFile::getPath() const {
+    return string(path);
+}
+
+const pmr::vector<ConfigFile::Entry>& ConfigFile::getEntries() const {
+    return entries;
+}
+
+void ConfigFile::getKey(const Entry& entry, string& key) {
+    appendKey(entry, key);
+}
+
+void ConfigFile::getKey(const Entry& entry, pmr::string& key) {
+    appendKey(entry, key);
+}
+
+void ConfigFile::getValues(const Entry& entry, vector<string>& values) {
+    appendValues(entry, values);
+}
+
+void ConfigFile::getValues(const Entry& entry, pmr::vector<pmr::string>& values) {
+    appendValues(entry, values);
+}
+
+} /* namespace cppargparser */
@@ -0,0 +1,163 @@
+// Copyright 2012, Fredy Wijaya
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the Lesser GNU General Public License as published by
+// the Free Software Foundation, either version 3.0 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// Lesser GNU General Public License for more details.
+//
+// You should have received a copy of the Lesser GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>
+
+#include "LongArgumentIndex.h"
+
+using namespace std;
+
+namespace cppargparser {
+
+namespace {
+
+const size_t NO_CHILD = static_cast<size_t>(-1);
+
+}
+
+const int LongArgumentIndex::NOT_FOUND;
+const int LongArgumentIndex::AMBIGUOUS;
+
+LongArgumentIndex::LongArgumentIndex() {
+    clear();
+}
+
+LongArgumentIndex::~LongArgumentIndex() {}
+
+void LongArgumentIndex::clear() {
+    nodes.clear();
+    newNode("", NOT_FOUND, 0, NOT_FOUND);
+}
+
+size_t LongArgumentIndex::newNode(const string& label, int id, int count,
+    int anyId) {
+    Node node;
+    node.label = label;
+    node.id = id;
+    node.count = count;
+    node.anyId = anyId;
+    nodes.push_back(node);
+    return nodes.size() - 1;
+}
+
+size_t LongArgumentIndex::findChild(const Node& node, char c) const {
+    // the children are sorted by their first character, so binary search
+    // keeps the lookup cheap even for nodes with many children
+    unsigned char uc = static_cast<unsigned char>(c);
+    size_t low = 0;
+    size_t high = node.children.size();
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        unsigned char m = static_cast<unsigned char>(nodes[node.children[mid]].label[0]);
+        if (m < uc) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    if (low < node.children.size() && nodes[node.children[low]].label[0] == c) {
+        return node.children[low];
+    }
+    return NO_CHILD;
+}
+
+void LongArgumentIndex::add(const string& name, int id) {
+    vector<size_t> path;
+    path.push_back(0);
+    size_t current = 0;
+    size_t pos = 0;
+    while (pos < name.size()) {
+        size_t child = findChild(nodes[current], name[pos]);
+        if (child == NO_CHILD) {
+            size_t leaf = newNode(name.substr(pos), NOT_FOUND, 0, NOT_FOUND);
+            vector<size_t>& children = nodes[current].children;
+            vector<size_t>::iterator i = children.begin();
+            while (i != children.end() &&
+                static_cast<unsigned char>(nodes[*i].label[0]) <
+                static_cast<unsigned char>(name[pos])) {
+                ++i;
+            }
+            children.insert(i, leaf);
+            path.push_back(leaf);
+            current = leaf;
+            break;
+        }
+        size_t common = 0;
+        while (common < nodes[child].label.size() && pos + common < name.size() &&
+            nodes[child].label[common] == name[pos + common]) {
+            ++common;
+        }
+        if (common < nodes[child].label.size()) {
+            // split the edge, e.g. adding --verb to --verbose creates an
+            // intermediate node --verb with a child ose
+            size_t middle = newNode(nodes[child].label.substr(0, common),
+                NOT_FOUND, nodes[child].count, nodes[child].anyId);
+            nodes[child].label.erase(0, common);
+            nodes[middle].children.push_back(child);
+            vector<size_t>& children = nodes[current].children;
+            for (size_t i = 0; i < children.size(); ++i) {
+                if (children[i] == child) {
+                    children[i] = middle;
+                    break;
+                }
+            }
+            child = middle;
+        }
+        path.push_back(child);
+        current = child;
+        pos += common;
+    }
+    // like ArgumentParser::addArgument, the first argument with a name keeps
+    // it, so an exact match and its prefixes always find the same id
+    if (nodes[current].id != NOT_FOUND) {
+        return;
+    }
+    nodes[current].id = id;
+    for (vector<size_t>::const_iterator i = path.begin(); i != path.end(); ++i) {
+        ++nodes[*i].count;
+        nodes[*i].anyId = id;
+    }
+}
+
+int LongArgumentIndex::find(string_view prefix) const {
+    size_t current = 0;
+    size_t pos = 0;
+    bool insideEdge = false;
+    while (pos < prefix.size()) {
+        size_t child = findChild(nodes[current], prefix[pos]);
+        if (child == NO_CHILD) {
+            return NOT_FOUND;
+        }
+        const string& label = nodes[child].label;
+        size_t n = prefix.size() - pos;
+        if (n > label.size()) {
+            n = label.size();
+        }
+        if (label.compare(0, n, prefix.substr(pos, n)) != 0) {
+            return NOT_FOUND;
+        }
+        pos += n;
+        current = child;
+        insideEdge = n < label.size();
+    }
+    const Node& node = nodes[current];
+    if (!insideEdge && node.id != NOT_FOUND) {
+        return node.id;
+    }
+    if (node.count == 0) {
+        return NOT_FOUND;
+    }
+    return (node.count == 1) ? node.anyId : AMBIGUOUS;
+}
+
+} /* namespace cppargparser */
@@ -20,43 +20,133 @@ using namespace std;
 
 namespace cppargparser {
 
+namespace {
+
+// the values of every flag, so that flags don't need to store anything but
+// their count
+const pmr::vector<pmr::string>& flagValues() {
+    static const pmr::vector<pmr::string> values(1);
+    return values;
+}
+
+}
+
+ParsedArgument::ParsedArgument(pmr::memory_resource* resource) :
+    args(resource),
+    values(resource),
+    sources(resource),
+    counts(resource),
+    flags(resource),
+    subcommand(resource) {
+}
+
 ParsedArgument::~ParsedArgument() {}
 
-void ParsedArgument::putArgument(const string& arg, const string& value) {
-    if (arg.size() == 0) {
-        return;
+size_t ParsedArgument::findOrAdd(string_view arg) {
+    ArgumentMap::const_iterator i = args.find(arg);
+    if (i != args.end()) {
+        return i->second;
     }
-    map<string, vector<string> >::iterator i = args.find(arg);
+    // the vector passes its memory resource to the new values
+    values.emplace_back();
+    sources.push_back(COMMAND_LINE);
+    counts.push_back(0);
+    flags.push_back(false);
+    args.emplace(arg, values.size() - 1);
+    return values.size() - 1;
+}
+
+size_t ParsedArgument::findOrAdd(string_view shortArg, string_view longArg) {
+    if (shortArg.empty()) {
+        return findOrAdd(longArg);
+    }
+    size_t index = findOrAdd(shortArg);
+    if (!longArg.empty()) {
+        args.emplace(longArg, index);
+    }
+    return index;
+}
+
+const ParsedArgument::Values& ParsedArgument::find(string_view arg) const {
+    ArgumentMap::const_iterator i = args.find(arg);
     if (i == args.end()) {
-        vector<string> v;
-        v.push_back(value);
-        args[arg] = v;
-    } else {
-        i->second.push_back(value);
+        throw InvalidArgumentException(string(arg) + " is an invalid argument");
+    }
+    return flags[i->second] ? flagValues() : values[i->second];
+}
+
+void ParsedArgument::putArgument(string_view arg, string_view value) {
+    if (arg.size() == 0) {
+        return;
     }
+    values[findOrAdd(arg)].emplace_back(value);
 }
 
 string ParsedArgument::getValue(const string& arg) const {
-    map<string, vector<string> >::const_iterator i = args.find(arg);
+    const Values& v = find(arg);
+    if (v.empty()) {
+        throw InvalidArgumentException(arg + " has no value");
+    }
+    // always return the first index
+    return string(v[0]);
+}
+
+ValueList ParsedArgument::getValues(const string& arg) const {
+    return ValueList(find(arg));
+}
+
+pmr::vector<pmr::string> ParsedArgument::takeValues(const string& arg) {
+    ArgumentMap::const_iterator i = args.find(string_view(arg));
     if (i == args.end()) {
         throw InvalidArgumentException(arg + " is an invalid argument");
     }
-    // always return the first index
-    return i->second[0];
+    if (flags[i->second]) {
+        return Values(flagValues(), getMemoryResource());
+    }
+    // moving keeps the memory resource, so the values aren't copied
+    Values taken(std::move(values[i->second]));
+    values[i->second].clear();
+    return taken;
 }
 
-vector<string> ParsedArgument::getValues(const string& arg) const {
-    map<string, vector<string> >::const_iterator i = args.find(arg);
+bool ParsedArgument::hasArgument(const string& arg) const {
+    return args.find(string_view(arg)) != args.end();
+}
+
+unsigned int ParsedArgument::getCount(const string& arg) const {
+    ArgumentMap::const_iterator i = args.find(string_view(arg));
+    return (i == args.end()) ? 0 : counts[i->second];
+}
+
+void ParsedArgument::setSource(const string& arg, Source source) {
+    ArgumentMap::const_iterator i = args.find(string_view(arg));
+    if (i != args.end()) {
+        sources[i->second] = source;
+    }
+}
+
+ParsedArgument::Source ParsedArgument::getSource(const string& arg) const {
+    ArgumentMap::const_iterator i = args.find(string_view(arg));
     if (i == args.end()) {
         throw InvalidArgumentException(arg + " is an invalid argument");
     }
+    return sources[i->second];
+}
 
-    return i->second;
+void ParsedArgument::setSubcommand(string_view _subcommand) {
+    subcommand.assign(_subcommand.begin(), _subcommand.end());
 }
 
-bool ParsedArgument::hasArgument(const string& arg) const {
-    map<string, vector<string> >::const_iterator i = args.find(arg);
-    return (i == args.end()) ? false : true;
+string ParsedArgument::getSubcommand() const {
+    return string(subcommand);
+}
+
+bool ParsedArgument::hasSubcommand() const {
+    return !subcommand.empty();
+}
+
+pmr::memory_resource* ParsedArgument::getMemoryResource() const {
+    return args.get_allocator().resource();
 }
 
 } /* namespace cppargparser */
@@ -0,0 +1,521 @@
+// Copyright 2012, Fredy Wijaya
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the Lesser GNU General Public License as published by
+// the Free Software Foundation, either version 3.0 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// Lesser GNU General Public License for more details.
+//
+// You should have received a copy of the Lesser GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>
+
+#include <algorithm>
+#include <bitset>
+#include <cctype>
+#include <map>
+#include "PatternValidator.h"
+#include "InvalidArgumentException.h"
+
+using namespace std;
+
+namespace cppargparser {
+
+namespace {
+
+// the DFA is built by the subset construction, which can blow up
+const size_t MAX_STATES = 4096;
+const int MAX_REPEAT = 1000;
+
+typedef bitset<256> CharSet;
+
+struct NfaState {
+    // the characters of the edge to next, next is -1 if there's no edge
+    CharSet chars;
+    int next;
+    vector<int> epsilons;
+};
+
+// a Thompson NFA fragment, nothing leaves end yet
+struct Fragment {
+    int start;
+    int end;
+};
+
+class NfaBuilder {
+public:
+    NfaBuilder(const string& _pattern) : pattern(_pattern), pos(0) {}
+
+    Fragment build() {
+        Fragment f = parseAlternation();
+        if (pos != pattern.size()) {
+            error();
+        }
+        return f;
+    }
+
+    vector<NfaState> states;
+
+private:
+    int newState() {
+        states.push_back(NfaState());
+        states.back().next = -1;
+        return static_cast<int>(states.size() - 1);
+    }
+
+    void link(int from, int to) {
+        states[from].epsilons.push_back(to);
+    }
+
+    Fragment empty() {
+        Fragment f;
+        f.start = newState();
+        f.end = newState();
+        link(f.start, f.end);
+        return f;
+    }
+
+    Fragment chars(const CharSet& set) {
+        Fragment f;
+        f.start = newState();
+        f.end = newState();
+        states[f.start].chars = set;
+        states[f.start].next = f.end;
+        return f;
+    }
+
+    Fragment concatenate(const Fragment& a, const Fragment& b) {
+        link(a.end, b.start);
+        Fragment f = { a.start, b.end };
+        return f;
+    }
+
+    Fragment optional(const Fragment& a) {
+        Fragment f = empty();
+        link(f.start, a.start);
+        link(a.end, f.end);
+        return f;
+    }
+
+    Fragment star(const Fragment& a) {
+        Fragment f = optional(a);
+        link(a.end, a.start);
+        return f;
+    }
+
+    void error() const {
+        throw InvalidArgumentException(pattern + " is an invalid pattern");
+    }
+
+    bool peek(char c) const {
+        return pos < pattern.size() && pattern[pos] == c;
+    }
+
+    Fragment parseAlternation() {
+        Fragment f = parseConcatenation();
+        while (peek('|')) {
+            ++pos;
+            Fragment b = parseConcatenation();
+            Fragment alt = empty();
+            states[alt.start].epsilons.clear();
+            link(alt.start, f.start);
+            link(alt.start, b.start);
+            link(f.end, alt.end);
+            link(b.end, alt.end);
+            f = alt;
+        }
+        return f;
+    }
+
+    Fragment parseConcatenation() {
+        Fragment f = empty();
+        while (pos < pattern.size() && !peek('|') && !peek(')')) {
+            f = concatenate(f, parseRepetition());
+        }
+        return f;
+    }
+
+    // the atom is parsed again for every copy that a {m,n} needs
+    Fragment parseRepetition() {
+        size_t atomPos = pos;
+        Fragment a = parseAtom();
+        if (pos >= pattern.size()) {
+            return a;
+        }
+        switch (pattern[pos]) {
+        case '*':
+            ++pos;
+            return star(a);
+        case '+': {
+            ++pos;
+            Fragment f = { a.start, newState() };
+            link(a.end, a.start);
+            link(a.end, f.end);
+            return f;
+        }
+        case '?':
+            ++pos;
+            return optional(a);
+        case '{':
+            break;
+        default:
+            return a;
+        }
+        ++pos;
+        int minCount = parseNumber();
+        int maxCount = minCount;
+        if (peek(',')) {
+            ++pos;
+            maxCount = peek('}') ? -1 : parseNumber();
+        }
+        if (!peek('}') || (maxCount != -1 && maxCount < minCount)) {
+            error();
+        }
+        ++pos;
+        int numCopies = (maxCount == -1) ? minCount + 1 : maxCount;
+        vector<Fragment> copies(1, a);
+        for (int i = 1; i < numCopies; ++i) {
+            copies.push_back(copyAtom(atomPos));
+        }
+        Fragment f = empty();
+        for (int i = 0; i < numCopies; ++i) {
+            if (i < minCount) {
+                f = concatenate(f, copies[i]);
+            } else if (maxCount == -1) {
+                f = concatenate(f, star(copies[i]));
+            } else {
+                f = concatenate(f, optional(copies[i]));
+            }
+        }
+        return f;
+    }
+
+    Fragment copyAtom(size_t atomPos) {
+        size_t savedPos = pos;
+        pos = atomPos;
+        Fragment f = parseAtom();
+        pos = savedPos;
+        return f;
+    }
+
+    int parseNumber() {
+        size_t start = pos;
+        int n = 0;
+        while (pos < pattern.size() && isdigit(static_cast<unsigned char>(pattern[pos]))) {
+            n = n * 10 + (pattern[pos] - '0');
+            if (n > MAX_REPEAT) {
+                error();
+            }
+            ++pos;
+        }
+        if (pos == start) {
+            error();
+        }
+        return n;
+    }
+
+    Fragment parseAtom() {
+        if (pos >= pattern.size()) {
+            error();
+        }
+        char c = pattern[pos++];
+        CharSet set;
+        switch (c) {
+        case '(': {
+            Fragment f = parseAlternation();
+            if (!peek(')')) {
+                error();
+            }
+            ++pos;
+            return f;
+        }
+        case '[':
+            return chars(parseClass());
+        case '.':
+            // any byte but the line terminators, U+2028 and U+2029 are
+            // multibyte sequences that can't be excluded byte by byte
+            set.set();
+            set.reset('\n');
+            set.reset('\r');
+            return chars(set);
+        case '\\':
+            return chars(parseEscape(false));
+        case ')': case '*': case '+': case '?': case '{': case '}': case '|': case ']':
+        case '^': case '$':
+            error();
+        }
+        set.set(static_cast<unsigned char>(c));
+        return chars(set);
+    }
+
+    /**
+     * Parses an escape after the backslash. Letters and digits other than
+     * the supported escapes are invalid, e.g. backreferences and word
+     * boundaries, instead of silently matching themselves.
+     * @param inClass whether the escape is in a character class, where \\b
+     *        is a backspace
+     */
+    CharSet parseEscape(bool inClass) {
+        if (pos >= pattern.size()) {
+            error();
+        }
+        char c = pattern[pos++];
+        CharSet set;
+        switch (c) {
+        case 't':
+            set.set('\t');
+            return set;
+        case 'n':
+            set.set('\n');
+            return set;
+        case 'r':
+            set.set('\r');
+            return set;
+        case 'f':
+            set.set('\f');
+            return set;
+        case 'v':
+            set.set('\v');
+            return set;
+        case 'b':
+            if (!inClass) {
+                error();
+            }
+            set.set('\b');
+            return set;
+        case '0':
+            // \0 followed by a digit would be an octal escape
+            if (pos < pattern.size() && isdigit(static_cast<unsigned char>(pattern[pos]))) {
+                error();
+            }
+            set.set(0);
+            return set;
+        case 'x':
+            set.set(parseHexByte());
+            return set;
+        case 'd': case 'D':
+            for (int b = '0'; b <= '9'; ++b) {
+                set.set(b);
+            }
+            break;
+        case 'w': case 'W':
+            for (int b = 0; b < 256; ++b) {
+                if (isalnum(b) || b == '_') {
+                    set.set(b);
+                }
+            }
+            break;
+        case 's': case 'S':
+            for (int b = 0; b < 256; ++b) {
+                if (isspace(b)) {
+                    set.set(b);
+                }
+            }
+            break;
+        default:
+            if (isalnum(static_cast<unsigned char>(c))) {
+                error();
+            }
+            set.set(static_cast<unsigned char>(c));
+            return set;
+        }
+        return isupper(static_cast<unsigned char>(c)) ? ~set : set;
+    }
+
+    unsigned char parseHexByte() {
+        int byte = 0;
+        for (int i = 0; i < 2; ++i) {
+            if (pos >= pattern.size() || !isxdigit(static_cast<unsigned char>(pattern[pos]))) {
+                error();
+            }
+            char c = pattern[pos++];
+            byte = byte * 16 + (isdigit(static_cast<unsigned char>(c)) ?
+                c - '0' : tolower(static_cast<unsigned char>(c)) - 'a' + 10);
+        }
+        return static_cast<unsigned char>(byte);
+    }
+
+    CharSet parseClass() {
+        CharSet set;
+        bool negated = peek('^');
+        if (negated) {
+            ++pos;
+        }
+        bool first = true;
+        while (pos < pattern.size() && (first || !peek(']'))) {
+            first = false;
+            CharSet atom;
+            int from = parseClassAtom(atom);
+            if (peek('-') && pos + 1 < pattern.size() && pattern[pos + 1] != ']') {
+                ++pos;
+                CharSet last;
+                int to = parseClassAtom(last);
+                // a class escape like \d can't start or end a range
+                if (from < 0 || to < from) {
+                    error();
+                }
+                for (int b = from; b <= to; ++b) {
+                    set.set(b);
+                }
+            } else {
+                set |= atom;
+            }
+        }
+        if (!peek(']')) {
+            error();
+        }
+        ++pos;
+        return negated ? ~set : set;
+    }
+
+    /**
+     * Parses a character or an escape in a character class.
+     * @param set the characters of the atom
+     * @return the character, which can start or end a range, or -1 for a
+     *         class escape like \d
+     */
+    int parseClassAtom(CharSet& set) {
+        if (!peek('\\')) {
+            unsigned char c = static_cast<unsigned char>(pattern[pos++]);
+            set.set(c);
+            return c;
+        }
+        ++pos;
+        bool classEscape = pos < pattern.size() &&
+            string("dDwWsS").find(pattern[pos]) != string::npos;
+        set = parseEscape(true);
+        if (classEscape) {
+            return -1;
+        }
+        int c = 0;
+        while (!set.test(c)) {
+            ++c;
+        }
+        return c;
+    }
+
+    const string& pattern;
+    size_t pos;
+};
+
+void closure(const vector<NfaState>& states, vector<int>& set) {
+    vector<char> inSet(states.size(), 0);
+    for (size_t i = 0; i < set.size(); ++i) {
+        inSet[set[i]] = 1;
+    }
+    for (size_t i = 0; i < set.size(); ++i) {
+        const vector<int>& epsilons = states[set[i]].epsilons;
+        for (size_t e = 0; e < epsilons.size(); ++e) {
+            if (!inSet[epsilons[e]]) {
+                inSet[epsilons[e]] = 1;
+                set.push_back(epsilons[e]);
+            }
+        }
+    }
+    sort(set.begin(), set.end());
+}
+
+}
+
+const int PatternValidator::DEAD;
+
+PatternValidator::PatternValidator(const string& _pattern) : pattern(_pattern) {
+    NfaBuilder builder(pattern);
+    Fragment nfa = builder.build();
+    const vector<NfaState>& states = builder.states;
+
+    // the bytes that belong to the same character sets behave the same, so
+    // they share a column of the transition table
+    map<vector<char>, unsigned char> signatures;
+    vector<int> representatives;
+    for (int b = 0; b < 256; ++b) {
+        vector<char> signature;
+        for (size_t s = 0; s < states.size(); ++s) {
+            if (states[s].next != -1) {
+                signature.push_back(states[s].chars.test(b) ? 1 : 0);
+            }
+        }
+        map<vector<char>, unsigned char>::const_iterator it = signatures.find(signature);
+        if (it == signatures.end()) {
+            it = signatures.insert(make_pair(signature,
+                static_cast<unsigned char>(representatives.size()))).first;
+            representatives.push_back(b);
+        }
+        columns[b] = it->second;
+    }
+    numColumns = representatives.size();
+
+    // the subset construction, each DFA state is a set of NFA states
+    map<vector<int>, int> ids;
+    vector<vector<int> > sets;
+    vector<int> start(1, nfa.start);
+    closure(states, start);
+    ids.insert(make_pair(start, 0));
+    sets.push_back(start);
+    for (size_t d = 0; d < sets.size(); ++d) {
+        accepting.push_back(binary_search(sets[d].begin(), sets[d].end(), nfa.end) ? 1 : 0);
+        for (size_t column = 0; column < numColumns; ++column) {
+            vector<int> next;
+            for (size_t i = 0; i < sets[d].size(); ++i) {
+                const NfaState& state = states[sets[d][i]];
+                if (state.next != -1 && state.chars.test(representatives[column])) {
+                    next.push_back(state.next);
+                }
+            }
+            if (next.empty()) {
+                transitions.push_back(DEAD);
+                continue;
+            }
+            closure(states, next);
+            map<vector<int>, int>::const_iterator it = ids.find(next);
+            if (it == ids.end()) {
+                if (sets.size() >= MAX_STATES) {
+                    throw InvalidArgumentException(pattern + " is a too complex pattern");
+                }
+                it = ids.insert(make_pair(next, static_cast<int>(sets.size()))).first;
+                sets.push_back(next);
+            }
+            transitions.push_back(it->second);
+        }
+    }
+}
+
+PatternValidator::~PatternValidator() {}
+
+bool PatternValidator::matches(string_view value) const {
+    int state = 0;
+    for (string_view::const_iterator c = value.begin(); c != value.end(); ++c) {
+        state = transitions[state * numColumns + columns[static_cast<unsigned char>(*c)]];
+        if (state == DEAD) {
+            return false;
+        }
+    }
+    return accepting[state] != 0;
+}
+
+bool PatternValidator::validate(const vector<string>& values) const {
+    for (vector<string>::const_iterator i = values.begin(); i != values.end(); ++i) {
+        if (!matches(*i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool PatternValidator::validate(const ValueList& values) const {
+    for (ValueList::const_iterator i = values.begin(); i != values.end(); ++i) {
+        if (!matches(*i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+const string& PatternValidator::getPattern() const {
+    return pattern;
+}
+
+} /* namespace cppargparser */
@@ -0,0 +1,115 @@
+// Copyright 2012, Fredy Wijaya
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the Lesser GNU General Public License as published by
+// the Free Software Foundation, either version 3.0 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// Lesser GNU General Public License for more details.
+//
+// You should have received a copy of the Lesser GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>
+
+#include "StringPool.h"
+#include <cstring>
+#include <functional>
+
+using namespace std;
+
+namespace cppargparser {
+
+const uint32_t StringPool::NOT_FOUND;
+const size_t StringPool::CHUNK_SIZE;
+
+StringPool::StringPool() : chunkUsed(0), chunkCapacity(0), bytes(0) {
+}
+
+StringPool::StringPool(const StringPool& other) :
+    chunkUsed(0), chunkCapacity(0), bytes(0) {
+    strings.reserve(other.strings.size());
+    for (vector<string_view>::const_iterator i = other.strings.begin();
+        i != other.strings.end(); ++i) {
+        intern(*i);
+    }
+}
+
+StringPool& StringPool::operator=(const StringPool& other) {
+    if (this != &other) {
+        StringPool copy(other);
+        chunks.swap(copy.chunks);
+        swap(chunkUsed, copy.chunkUsed);
+        swap(chunkCapacity, copy.chunkCapacity);
+        swap(bytes, copy.bytes);
+        strings.swap(copy.strings);
+        ids.swap(copy.ids);
+    }
+    return *this;
+}
+
+StringPool::~StringPool() {
+}
+
+uint32_t StringPool::intern(string_view s) {
+    if ((strings.size() + 1) * 2 > ids.size()) {
+        grow();
+    }
+    size_t slot = findSlot(s);
+    if (ids[slot] != NOT_FOUND) {
+        return ids[slot];
+    }
+    if (chunks.empty() || s.size() > chunkCapacity - chunkUsed) {
+        // a string longer than a chunk gets a chunk of its own
+        chunkCapacity = max(CHUNK_SIZE, s.size());
+        chunks.emplace_back(new char[chunkCapacity]);
+        chunkUsed = 0;
+    }
+    char* data = chunks.back().get() + chunkUsed;
+    memcpy(data, s.data(), s.size());
+    chunkUsed += s.size();
+    bytes += s.size();
+
+    uint32_t id = static_cast<uint32_t>(strings.size());
+    strings.push_back(string_view(data, s.size()));
+    ids[slot] = id;
+    return id;
+}
+
+uint32_t StringPool::find(string_view s) const {
+    return ids.empty() ? NOT_FOUND : ids[findSlot(s)];
+}
+
+size_t StringPool::findSlot(string_view s) const {
+    // linear probing from the hash, the table is never full so an empty
+    // slot ends the search
+    size_t mask = ids.size() - 1;
+    size_t slot = hash<string_view>()(s) & mask;
+    while (ids[slot] != NOT_FOUND && strings[ids[slot]] != s) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+void StringPool::grow() {
+    vector<uint32_t> table(ids.empty() ? 16 : ids.size() * 2, NOT_FOUND);
+    ids.swap(table);
+    for (uint32_t id = 0; id < strings.size(); ++id) {
+        ids[findSlot(strings[id])] = id;
+    }
+}
+
+string_view StringPool::get(uint32_t id) const {
+    return strings[id];
+}
+
+size_t StringPool::size() const {
+    return strings.size();
+}
+
+size_t StringPool::getBytes() const {
+    return bytes;
+}
+
+} /* namespace cppargparser */
@@ -0,0 +1,90 @@
+// Copyright 2012, Fredy Wijaya
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the Lesser GNU General Public License as published by
+// the Free Software Foundation, either version 3.0 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// Lesser GNU General Public License for more details.
+//
+// You should have received a copy of the Lesser GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>
+
+#include "ValidatorPipeline.h"
+
+using namespace std;
+
+namespace cppargparser {
+
+double ValidatorPipeline::Stats::getRejectionRate() const {
+    return (executions == 0) ? 0.0 : static_cast<double>(rejections) / executions;
+}
+
+ValidatorPipeline::ValidatorPipeline() {}
+
+ValidatorPipeline::~ValidatorPipeline() {}
+
+ValidatorPipeline& ValidatorPipeline::add(const Validator* validator, unsigned int cost) {
+    return add(unownedValidator(validator), cost);
+}
+
+ValidatorPipeline& ValidatorPipeline::add(shared_ptr<const Validator> validator,
+    unsigned int cost) {
+    unique_ptr<Stage> stage(new Stage());
+    stage->validator = std::move(validator);
+    stage->cost = cost;
+    stage->executions.store(0, memory_order_relaxed);
+    stage->rejections.store(0, memory_order_relaxed);
+    // insert after the stages with the same cost so that they keep the order
+    // they are added in
+    vector<unique_ptr<Stage> >::iterator i = stages.begin();
+    while (i != stages.end() && (*i)->cost <= cost) {
+        ++i;
+    }
+    stages.insert(i, std::move(stage));
+    return *this;
+}
+
+bool ValidatorPipeline::validate(const vector<string>& values) const {
+    return validateValues(values);
+}
+
+bool ValidatorPipeline::validate(const ValueList& values) const {
+    return validateValues(values);
+}
+
+template <typename Values>
+bool ValidatorPipeline::validateValues(const Values& values) const {
+    for (vector<unique_ptr<Stage> >::const_iterator i = stages.begin();
+        i != stages.end(); ++i) {
+        Stage& stage = **i;
+        // the counters are only statistics, so they don't need any ordering
+        stage.executions.fetch_add(1, memory_order_relaxed);
+        if (!stage.validator->validate(values)) {
+            stage.rejections.fetch_add(1, memory_order_relaxed);
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t ValidatorPipeline::size() const {
+    return stages.size();
+}
+
+const Validator* ValidatorPipeline::getValidator(size_t i) const {
+    return stages[i]->validator.get();
+}
+
+ValidatorPipeline::Stats ValidatorPipeline::getStats(size_t i) const {
+    Stats stats;
+    stats.cost = stages[i]->cost;
+    stats.executions = stages[i]->executions.load(memory_order_relaxed);
+    stats.rejections = stages[i]->rejections.load(memory_order_relaxed);
+    return stats;
+}
+
+} /* namespace cppargparser */
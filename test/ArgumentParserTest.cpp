@@ -15,16 +15,56 @@
 
 #include <gtest/gtest.h>
 #include "ArgumentParser.h"
+#include "PatternValidator.h"
 #include "InvalidArgumentException.h"
 #include <sstream>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <atomic>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
 
 using namespace std;
 using namespace testing;
 using namespace cppargparser;
 
+namespace {
+
+// a memory resource that counts the allocations it makes from another one
+class CountingResource : public pmr::memory_resource {
+public:
+    explicit CountingResource(pmr::memory_resource* _upstream) :
+        allocations(0), bytes(0), upstream(_upstream) {}
+
+    size_t allocations;
+    size_t bytes;
+
+private:
+    void* do_allocate(size_t size, size_t alignment) {
+        ++allocations;
+        bytes += size;
+        return upstream->allocate(size, alignment);
+    }
+
+    void do_deallocate(void* p, size_t size, size_t alignment) {
+        upstream->deallocate(p, size, alignment);
+    }
+
+    bool do_is_equal(const pmr::memory_resource& other) const noexcept {
+        return this == &other;
+    }
+
+    pmr::memory_resource* upstream;
+};
+
+}
+
 class PortNumberValidator : public Validator {
 public:
-    bool validate(const vector<string>& values) {
+    bool validate(const vector<string>& values) const {
         for (vector<string>::const_iterator i = values.begin(); i != values.end(); ++i) {
             istringstream iss(*i);
             int port;
@@ -402,3 +442,1037 @@ TEST(ArgumentParserTest, ParseInvalidArgumentWithValidator) {
     char** argv = const_cast<char**>(cargv);
     EXPECT_THROW(argParser.parse(2, argv), InvalidArgumentException);
 }
+
+TEST(ArgumentParserTest, GetHelp) {
+    ArgumentParser argParser;
+    argParser.addArgument(Argument("-a", "--aaa", "aaa description", 1, true));
+    argParser.addArgument(Argument("-b", "bbb description", Argument::SHORT, 0, false));
+
+    EXPECT_EQ(
+        "Usage: test_program\n"
+        "Options:\n"
+        "    -a, --aaa    aaa description\n"
+        "    -b           bbb description\n",
+        argParser.getHelp("test_program"));
+}
+
+TEST(ArgumentParserTest, GetHelpLongArgument) {
+    ArgumentParser argParser;
+    string longArg = "--" + string(60, 'x');
+    argParser.addArgument(Argument(longArg, "long description", Argument::LONG, 0, false));
+    argParser.addArgument(Argument("-a", "short description", Argument::SHORT, 0, false));
+
+    EXPECT_EQ(
+        "Usage: test_program\n"
+        "Options:\n"
+        "    " + longArg + "    long description\n"
+        "    -a" + string(longArg.size() + 2, ' ') + "short description\n",
+        argParser.getHelp("test_program"));
+}
+
+TEST(ArgumentParserTest, CopyParserWithSharedDescriptions) {
+    ArgumentParser* argParser = new ArgumentParser();
+    string desc = "shared description";
+    argParser->addArgument(Argument("-a", "--aaa", desc, 1, false));
+    argParser->addArgument(Argument("-b", desc, Argument::SHORT, 0, false));
+    // the copy doesn't refer to the names and descriptions of the original
+    ArgumentParser copy(*argParser);
+    delete argParser;
+
+    EXPECT_EQ(
+        "Usage: test_program\n"
+        "Options:\n"
+        "    -a, --aaa    shared description\n"
+        "    -b           shared description\n",
+        copy.getHelp("test_program"));
+    const char* cargv[] = { "test_program", "--aaa", "1", "-b" };
+    char** argv = const_cast<char**>(cargv);
+    ParsedArgument pa = copy.parse(4, argv);
+    EXPECT_EQ("1", pa.getValue("-a"));
+    EXPECT_TRUE(pa.hasArgument("-b"));
+}
+
+TEST(ArgumentParserTest, GetHelpIsRenderedAgainAfterAddingArgument) {
+    ArgumentParser argParser;
+    argParser.addArgument(Argument("-a", "aaa description", Argument::SHORT, 0, false));
+    string help = argParser.getHelp("test_program");
+    EXPECT_EQ(&argParser.getHelp("test_program"), &argParser.getHelp("test_program"));
+
+    argParser.addArgument(Argument("-b", "bbb description", Argument::SHORT, 0, false));
+    EXPECT_NE(help, argParser.getHelp("test_program"));
+    EXPECT_NE(string::npos, argParser.getHelp("test_program").find("bbb description"));
+}
+
+class CountingArgumentParserFactory : public ArgumentParserFactory {
+public:
+    CountingArgumentParserFactory(const string& _arg) : arg(_arg), count(0) {}
+
+    ArgumentParser* create() const {
+        ++count;
+        ArgumentParser* argParser = new ArgumentParser();
+        argParser->addArgument(Argument(arg, arg + " arg", Argument::LONG, 1, true));
+        return argParser;
+    }
+
+    string arg;
+    mutable int count;
+};
+
+TEST(ArgumentParserTest, ParseAbbreviatedDuplicateLongArgument) {
+    ArgumentParser argParser;
+    argParser.setAllowAbbreviation(true);
+    argParser.addArgument(Argument("-a", "--verbose", "first", 0, false));
+    argParser.addArgument(Argument("-b", "--verbose", "second", 0, false));
+
+    const char* cargv[] = { "test_program", "--verbose" };
+    char** argv = const_cast<char**>(cargv);
+    ParsedArgument pa = argParser.parse(2, argv);
+    EXPECT_TRUE(pa.hasArgument("-a"));
+    EXPECT_FALSE(pa.hasArgument("-b"));
+
+    const char* cargv2[] = { "test_program", "--verb" };
+    argv = const_cast<char**>(cargv2);
+    pa = argParser.parse(2, argv);
+    EXPECT_TRUE(pa.hasArgument("-a"));
+    EXPECT_FALSE(pa.hasArgument("-b"));
+}
+
+TEST(ArgumentParserTest, ParseSubcommand) {
+    CountingArgumentParserFactory buildFactory("--target");
+    CountingArgumentParserFactory testFactory("--filter");
+    ArgumentParser argParser;
+    argParser.addArgument(Argument("-v", "--verbose", "verbose", 0, false));
+    argParser.addSubcommand("build", "build a target", &buildFactory);
+    argParser.addSubcommand("test", "run the tests", &testFactory);
+
+    const char* cargv[] = { "test_program", "-v", "build", "--target", "all" };
+    char** argv = const_cast<char**>(cargv);
+    ParsedArgument pa = argParser.parse(5, argv);
+
+    EXPECT_TRUE(pa.hasSubcommand());
+    EXPECT_EQ("build", pa.getSubcommand());
+    EXPECT_TRUE(pa.hasArgument("--verbose"));
+    EXPECT_EQ("all", pa.getValue("--target"));
+    EXPECT_FALSE(pa.hasArgument("--filter"));
+    EXPECT_EQ(1, buildFactory.count);
+    EXPECT_EQ(0, testFactory.count);
+}
+
+TEST(ArgumentParserTest, ParseSubcommandMissingMandatoryArgument) {
+    CountingArgumentParserFactory buildFactory("--target");
+    ArgumentParser argParser;
+    argParser.addSubcommand("build", "build a target", &buildFactory);
+
+    const char* cargv[] = { "test_program", "build" };
+    char** argv = const_cast<char**>(cargv);
+    EXPECT_THROW(argParser.parse(2, argv), InvalidArgumentException);
+}
+
+TEST(ArgumentParserTest, ParseWithoutSubcommand) {
+    CountingArgumentParserFactory buildFactory("--target");
+    ArgumentParser argParser;
+    argParser.addArgument(Argument("-v", "--verbose", "verbose", 0, false));
+    argParser.addSubcommand("build", "build a target", &buildFactory);
+
+    const char* cargv[] = { "test_program", "-v", "deploy" };
+    char** argv = const_cast<char**>(cargv);
+    EXPECT_THROW(argParser.parse(3, argv), InvalidArgumentException);
+    EXPECT_EQ(0, buildFactory.count);
+}
+
+TEST(ArgumentParserTest, ParseSubcommandSharingStrings) {
+    CountingArgumentParserFactory buildFactory("--target");
+    ArgumentParser argParser;
+    // the names and the descriptions are interned in the same pool, so the
+    // same string can be a subcommand description and an argument name
+    argParser.addSubcommand("build", "--verbose", &buildFactory);
+    argParser.addSubcommand("run", "build", &buildFactory);
+    argParser.addArgument(Argument("-v", "--verbose", "run", 0, false));
+    argParser.addArgument(Argument("files", "build", Argument::POSITIONAL,
+        Argument::INFINITY, false));
+
+    const char* cargv[] = { "test_program", "-v", "files" };
+    char** argv = const_cast<char**>(cargv);
+    ParsedArgument pa = argParser.parse(3, argv);
+    EXPECT_FALSE(pa.hasSubcommand());
+    EXPECT_EQ("files", pa.getValue("files"));
+
+    const char* cargv2[] = { "test_program", "--verbose", "run", "--target", "all" };
+    argv = const_cast<char**>(cargv2);
+    pa = argParser.parse(5, argv);
+    EXPECT_TRUE(pa.hasArgument("--verbose"));
+    EXPECT_EQ("run", pa.getSubcommand());
+    EXPECT_EQ("all", pa.getValue("--target"));
+}
+
+TEST(ArgumentParserTest, GetHelpWithSubcommands) {
+    CountingArgumentParserFactory buildFactory("--target");
+    ArgumentParser argParser;
+    argParser.addArgument(Argument("-v", "verbose", Argument::SHORT, 0, false));
+    argParser.addSubcommand("build", "build a target", &buildFactory);
+
+    EXPECT_EQ(
+        "Usage: test_program\n"
+        "Options:\n"
+        "    -v       verbose\n"
+        "Commands:\n"
+        "    build    build a target\n",
+        argParser.getHelp("test_program"));
+    EXPECT_EQ(0, buildFactory.count);
+}
+
+TEST(ArgumentParserTest, ParseAbbreviatedLongArguments) {
+    ArgumentParser argParser;
+    argParser.setAllowAbbreviation(true);
+    argParser.addArgument(Argument("--verbose", "verbose", Argument::LONG, 0, true));
+    argParser.addArgument(Argument("-p", "--port", "port", 1, true));
+
+    const char* cargv[] = { "test_program", "--verb", "--po=8888" };
+    char** argv = const_cast<char**>(cargv);
+    ParsedArgument pa = argParser.parse(3, argv);
+
+    EXPECT_TRUE(pa.hasArgument("--verbose"));
+    EXPECT_EQ("8888", pa.getValue("--port"));
+    EXPECT_EQ("8888", pa.getValue("-p"));
+}
+
+TEST(ArgumentParserTest, ParseAmbiguousLongArgument) {
+    ArgumentParser argParser;
+    argParser.setAllowAbbreviation(true);
+    argParser.addArgument(Argument("--verbose", "verbose", Argument::LONG, 0, false));
+    argParser.addArgument(Argument("--version", "version", Argument::LONG, 0, false));
+
+    const char* cargv[] = { "test_program", "--ver" };
+    char** argv = const_cast<char**>(cargv);
+    EXPECT_THROW(argParser.parse(2, argv), InvalidArgumentException);
+}
+
+TEST(ArgumentParserTest, ParseAbbreviatedEmptyLongArgument) {
+    ArgumentParser argParser;
+    argParser.setAllowAbbreviation(true);
+    argParser.addArgument(Argument("--out", "out", Argument::LONG, 1, false));
+
+    const char* cargv[] = { "test_program", "--=x" };
+    char** argv = const_cast<char**>(cargv);
+    EXPECT_THROW(argParser.parse(2, argv), InvalidArgumentException);
+}
+
+TEST(ArgumentParserTest, ParseAbbreviatedLongArgumentNotAllowed) {
+    ArgumentParser argParser;
+    argParser.addArgument(Argument("--verbose", "verbose", Argument::LONG, 0, false));
+
+    const char* cargv[] = { "test_program", "--verb" };
+    char** argv = const_cast<char**>(cargv);
+    EXPECT_THROW(argParser.parse(2, argv), InvalidArgumentException);
+}
+
+TEST(ArgumentParserTest, ParseBundledShortArguments) {
+    ArgumentParser argParser;
+    argParser.addArgument(Argument("-x", "--extract", "extract", 0, true));
+    argParser.addArgument(Argument("-z", "--gzip", "gzip", 0, false));
+    argParser.addArgument(Argument("-f", "--file", "file", 1, true));
+    argParser.addArgument(Argument("-v", "verbose", Argument::SHORT, 0, false));
+
+    const char* cargv[] = { "test_program", "-xzf", "foo.tar.gz" };
+    char** argv = const_cast<char**>(cargv);
+    ParsedArgument pa = argParser.parse(3, argv);
+
+    EXPECT_TRUE(pa.hasArgument("-x"));
+    EXPECT_TRUE(pa.hasArgument("--gzip"));
+    EXPECT_EQ("foo.tar.gz", pa.getValue("-f"));
+    EXPECT_FALSE(pa.hasArgument("-v"));
+}
+
+TEST(ArgumentParserTest, ParseShortArgumentWithAttachedValue) {
+    ArgumentParser argParser;
+    argParser.addArgument(Argument("-x", "--extract", "extract", 0, true));
+    argParser.addArgument(Argument("-f", "--file", "file", 1, true));
+
+    const char* cargv[] = { "test_program", "-xffoo.tar.gz" };
+    char** argv = const_cast<char**>(cargv);
+    ParsedArgument pa = argParser.parse(2, argv);
+
+    EXPECT_TRUE(pa.hasArgument("-x"));
+    EXPECT_EQ("foo.tar.gz", pa.getValue("--file"));
+}
+
+TEST(ArgumentParserTest, ParseManySplitTokens) {
+    ArgumentParser argParser;
+    argParser.addArgument(Argument("-l", "--list", "list", Argument::INFINITY, false)
+        .setDuplicatePolicy(Argument::APPEND));
+    argParser.addArgument(Argument("-v", "verbose", Argument::SHORT, 0, false)
+        .setDuplicatePolicy(Argument::FIRST_WINS));
+    argParser.addArgument(Argument("-o", "output", Argument::SHORT, 1, false)
+        .setDuplicatePolicy(Argument::LAST_WINS));
+
+    // the split tokens reuse the slots of the consumed tokens, except at the
+    // start where there are none
+    vector<string> tokens;
+    tokens.push_back("test_program");
+    tokens.push_back("-vvvo1");
+    for (int i = 0; i < 1000; ++i) {
+        tokens.push_back("--list=" + to_string(i));
+        tokens.push_back("x" + to_string(i));
+        tokens.push_back("-vo" + to_string(i));
+    }
+    vector<char*> argv;
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        argv.push_back(&tokens[i][0]);
+    }
+    ParsedArgument pa = argParser.parse(static_cast<int>(argv.size()), &argv[0]);
+
+    EXPECT_EQ(1003u, pa.getCount("-v"));
+    EXPECT_EQ("999", pa.getValue("-o"));
+    vector<string> list = pa.getValues("--list");
+    ASSERT_EQ(2000u, list.size());
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(to_string(i), list[2 * i]);
+        EXPECT_EQ("x" + to_string(i), list[2 * i + 1]);
+    }
+}
+
+TEST(ArgumentParserTest, ParseBundledShortArgumentsUnknownArgument) {
+    ArgumentParser argParser;
+    argParser.addArgument(Argument("-x", "--extract", "extract", 0, false));
+    argParser.addArgument(Argument("-z", "--gzip", "gzip", 0, false));
+
+    const char* cargv[] = { "test_program", "-xzq" };
+    char** argv = const_cast<char**>(cargv);
+    EXPECT_THROW(argParser.parse(2, argv), InvalidArgumentException);
+}
+
+TEST(ArgumentParserTest, ParseMultiCharacterShortArgumentIsNotExpanded) {
+    ArgumentParser argParser;
+    argParser.addArgument(Argument("-a", "aaa", Argument::SHORT, 0, false));
+    argParser.addArgument(Argument("-b", "bbb", Argument::SHORT, 0, false));
+    argParser.addArgument(Argument("-ab", "ab", Argument::SHORT, 1, false));
+
+    const char* cargv[] = { "test_program", "-ab", "1" };
+    char** argv = const_cast<char**>(cargv);
+    ParsedArgument pa = argParser.parse(3, argv);
+
+    EXPECT_EQ("1", pa.getValue("-ab"));
+    EXPECT_FALSE(pa.hasArgument("-a"));
+    EXPECT_FALSE(pa.hasArgument("-b"));
+}
+
+TEST(ArgumentParserTest, ParseTwice) {
+    ArgumentParser argParser;
+    argParser.addArgument(Argument("-a", "--aaa", "aaa", 1, true));
+
+    const char* cargv1[] = { "test_program", "-a", "1" };
+    const char* cargv2[] = { "test_program", "--aaa", "2" };
+    EXPECT_EQ("1", argParser.parse(3, const_cast<char**>(cargv1)).getValue("-a"));
+    EXPECT_EQ("2", argParser.parse(3, const_cast<char**>(cargv2)).getValue("-a"));
+}
+
+TEST(ArgumentParserTest, ParseEnvironmentFallback) {
+    setenv("CPPARGPARSER_TEST_LOG_LEVEL", "debug", 1);
+    setenv("CPPARGPARSER_TEST_PORT", "1234", 1);
+    setenv("CPPARGPARSER_TEST_HOSTS", "foo bar  baz", 1);
+    setenv("CPPARGPARSER_TEST_V", "1", 1);
+    ArgumentParser argParser;
+    argParser.setEnvironmentPrefix("CPPARGPARSER_TEST");
+    argParser.addArgument(Argument("-l", "--log-level", "log level", 1, true));
+    argParser.addArgument(Argument("-p", "--port", "port", 1, true));
+    argParser.addArgument(Argument("--hosts", "hosts", Argument::LONG,
+        Argument::INFINITY, false));
+    argParser.addArgument(Argument("-v", "verbose", Argument::SHORT, 0, false));
+
+    const char* cargv[] = { "test_program", "--port", "8888" };
+    char** argv = const_cast<char**>(cargv);
+    ParsedArgument pa = argParser.parse(3, argv);
+
+    EXPECT_EQ("debug", pa.getValue("-l"));
+    EXPECT_EQ("debug", pa.getValue("--log-level"));
+    EXPECT_EQ(ParsedArgument::ENVIRONMENT, pa.getSource("--log-level"));
+    EXPECT_EQ("8888", pa.getValue("--port"));
+    EXPECT_EQ(ParsedArgument::COMMAND_LINE, pa.getSource("--port"));
+    vector<string> hosts = pa.getValues("--hosts");
+    ASSERT_EQ(3u, hosts.size());
+    EXPECT_EQ("foo", hosts[0]);
+    EXPECT_EQ("baz", hosts[2]);
+    EXPECT_TRUE(pa.hasArgument("-v"));
+    EXPECT_EQ(ParsedArgument::ENVIRONMENT, pa.getSource("-v"));
+    unsetenv("CPPARGPARSER_TEST_LOG_LEVEL");
+    unsetenv("CPPARGPARSER_TEST_PORT");
+    unsetenv("CPPARGPARSER_TEST_HOSTS");
+    unsetenv("CPPARGPARSER_TEST_V");
+}
+
+TEST(ArgumentParserTest, ParseEnvironmentFallbackWithoutPrefix) {
+    setenv("CPPARGPARSER_TEST_PORT", "1234", 1);
+    ArgumentParser argParser;
+    argParser.addArgument(Argument("-p", "--port", "port", 1, true));
+
+    const char* cargv[] = { "test_program" };
+    char** argv = const_cast<char**>(cargv);
+    EXPECT_THROW(argParser.parse(1, argv), InvalidArgumentException);
+    unsetenv("CPPARGPARSER_TEST_PORT");
+}
+
+TEST(ArgumentParserTest, ParseEnvironmentFallbackInvalidValue) {
+    setenv("CPPARGPARSER_TEST_PORT", "99999", 1);
+    setenv("CPPARGPARSER_TEST_B", "1", 1);
+    PortNumberValidator validator;
+    ArgumentParser argParser;
+    argParser.setEnvironmentPrefix("CPPARGPARSER_TEST");
+    argParser.addArgument(Argument("-p", "--port", "port", 1, true, &validator));
+    argParser.addArgument(Argument("-b", "-b arg1 arg2", Argument::SHORT, 2, false));
+
+    const char* cargv[] = { "test_program", "-b", "1", "2" };
+    char** argv = const_cast<char**>(cargv);
+    EXPECT_THROW(argParser.parse(4, argv), InvalidArgumentException);
+
+    const char* cargv2[] = { "test_program", "-p", "1" };
+    argv = const_cast<char**>(cargv2);
+    EXPECT_THROW(argParser.parse(3, argv), InvalidArgumentException);
+    unsetenv("CPPARGPARSER_TEST_PORT");
+    unsetenv("CPPARGPARSER_TEST_B");
+}
+
+TEST(ArgumentParserTest, ParseEnvironmentFlags) {
+    ArgumentParser argParser;
+    argParser.setEnvironmentPrefix("CPPARGPARSER_TEST");
+    argParser.addArgument(Argument("-v", "--verbose", "verbose", 0, false));
+    const char* cargv[] = { "test_program" };
+    char** argv = const_cast<char**>(cargv);
+
+    const char* off[] = { "0", "false", "", "Off" };
+    for (size_t i = 0; i < sizeof(off) / sizeof(off[0]); ++i) {
+        setenv("CPPARGPARSER_TEST_VERBOSE", off[i], 1);
+        EXPECT_FALSE(argParser.parse(1, argv).hasArgument("-v")) << off[i];
+    }
+    setenv("CPPARGPARSER_TEST_VERBOSE", "TRUE", 1);
+    EXPECT_TRUE(argParser.parse(1, argv).hasArgument("-v"));
+    setenv("CPPARGPARSER_TEST_VERBOSE", "maybe", 1);
+    try {
+        argParser.parse(1, argv);
+        FAIL();
+    } catch (const InvalidArgumentException& e) {
+        EXPECT_STREQ("CPPARGPARSER_TEST_VERBOSE is an invalid flag value", e.what());
+    }
+    unsetenv("CPPARGPARSER_TEST_VERBOSE");
+}
+
+TEST(ArgumentParserTest, ParseConfigFileFlags) {
+    ArgumentParser argParser;
+    argParser.addConfigFile("cppargparser_test_user.conf");
+    argParser.addArgument(Argument("-v", "--verbose", "verbose", 0, false));
+    const char* cargv[] = { "test_program" };
+    char** argv = const_cast<char**>(cargv);
+
+    const char* off[] = { "0", "false", "" };
+    for (size_t i = 0; i < sizeof(off) / sizeof(off[0]); ++i) {
+        {
+            ofstream user("cppargparser_test_user.conf");
+            user << "verbose = " << off[i] << "\n";
+        }
+        EXPECT_FALSE(argParser.parse(1, argv).hasArgument("-v")) << off[i];
+    }
+    {
+        ofstream user("cppargparser_test_user.conf");
+        user << "verbose = yes\n";
+    }
+    EXPECT_TRUE(argParser.parse(1, argv).hasArgument("-v"));
+    remove("cppargparser_test_user.conf");
+}
+
+TEST(ArgumentParserTest, ParseConfigFiles) {
+    {
+        ofstream system("cppargparser_test_system.conf");
+        system << "log-level = info\n"
+            << "port = 80\n"
+            << "hosts = [foo, bar]\n"
+            << "verbose = true\n"
+            << "b = 1 2\n"
+            << "unknown = whatever\n";
+        ofstream user("cppargparser_test_user.conf");
+        user << "# user settings\n"
+            << "log-level = debug\n"
+            << "verbose = off\n";
+    }
+    ArgumentParser argParser;
+    argParser.addConfigFile("cppargparser_test_system.conf");
+    argParser.addConfigFile("cppargparser_test_user.conf");
+    argParser.addConfigFile("cppargparser_test_missing.conf");
+    argParser.addArgument(Argument("-l", "--log-level", "log level", 1, true));
+    argParser.addArgument(Argument("-p", "--port", "port", 1, true));
+    argParser.addArgument(Argument("--hosts", "hosts", Argument::LONG,
+        Argument::INFINITY, false));
+    argParser.addArgument(Argument("-v", "--verbose", "verbose", 0, false));
+    argParser.addArgument(Argument("-b", "-b arg1 arg2", Argument::SHORT, 2, false));
+
+    const char* cargv[] = { "test_program", "--port", "8888" };
+    char** argv = const_cast<char**>(cargv);
+    ParsedArgument pa = argParser.parse(3, argv);
+    remove("cppargparser_test_system.conf");
+    remove("cppargparser_test_user.conf");
+
+    EXPECT_EQ("debug", pa.getValue("--log-level"));
+    EXPECT_EQ(ParsedArgument::CONFIG_FILE, pa.getSource("-l"));
+    EXPECT_EQ("8888", pa.getValue("--port"));
+    EXPECT_EQ(ParsedArgument::COMMAND_LINE, pa.getSource("--port"));
+    vector<string> hosts = pa.getValues("--hosts");
+    ASSERT_EQ(2u, hosts.size());
+    EXPECT_EQ("foo", hosts[0]);
+    EXPECT_EQ("bar", hosts[1]);
+    EXPECT_FALSE(pa.hasArgument("--verbose"));
+    vector<string> b = pa.getValues("-b");
+    ASSERT_EQ(2u, b.size());
+    EXPECT_EQ("2", b[1]);
+}
+
+TEST(ArgumentParserTest, ParseConfigFilesEnvironmentTakesPrecedence) {
+    {
+        ofstream user("cppargparser_test_user.conf");
+        user << "port = 80\n";
+    }
+    setenv("CPPARGPARSER_TEST_PORT", "1234", 1);
+    ArgumentParser argParser;
+    argParser.setEnvironmentPrefix("CPPARGPARSER_TEST");
+    argParser.addConfigFile("cppargparser_test_user.conf");
+    argParser.addArgument(Argument("-p", "--port", "port", 1, true));
+
+    const char* cargv[] = { "test_program" };
+    char** argv = const_cast<char**>(cargv);
+    ParsedArgument pa = argParser.parse(1, argv);
+    remove("cppargparser_test_user.conf");
+    unsetenv("CPPARGPARSER_TEST_PORT");
+
+    EXPECT_EQ("1234", pa.getValue("--port"));
+    EXPECT_EQ(ParsedArgument::ENVIRONMENT, pa.getSource("--port"));
+}
+
+TEST(ArgumentParserTest, ParseConfigFilesInvalidValue) {
+    {
+        ofstream user("cppargparser_test_user.conf");
+        user << "verbose = maybe\n";
+    }
+    ArgumentParser argParser;
+    argParser.addConfigFile("cppargparser_test_user.conf");
+    argParser.addArgument(Argument("-v", "--verbose", "verbose", 0, false));
+
+    const char* cargv[] = { "test_program" };
+    char** argv = const_cast<char**>(cargv);
+    EXPECT_THROW(argParser.parse(1, argv), InvalidArgumentException);
+    remove("cppargparser_test_user.conf");
+}
+
+TEST(ArgumentParserTest, ParseWithMemoryResourceFromEnvironmentAndConfigFiles) {
+    {
+        ofstream user("cppargparser_test_user.conf");
+        user << "log-level = a log level that does not fit in a small string\n"
+            << "hosts = [foo, \"a host that does not fit in a small string\"]\n"
+            << "b = 1 2\n"
+            << "verbose = true\n";
+    }
+    setenv("CPPARGPARSER_TEST_A_LONG_ENVIRONMENT_NAME", "a value that does not fit", 1);
+    setenv("CPPARGPARSER_TEST_FLAG", "yes", 1);
+    ArgumentParser argParser;
+    argParser.setEnvironmentPrefix("CPPARGPARSER_TEST");
+    argParser.addConfigFile("cppargparser_test_user.conf");
+    argParser.addArgument(Argument("--a-long-environment-name", "a", Argument::LONG, 1, true));
+    argParser.addArgument(Argument("--flag", "flag", Argument::LONG, 0, false));
+    argParser.addArgument(Argument("-l", "--log-level", "log level", 1, true));
+    argParser.addArgument(Argument("--hosts", "hosts", Argument::LONG,
+        Argument::INFINITY, false));
+    argParser.addArgument(Argument("-b", "-b arg1 arg2", Argument::SHORT, 2, false));
+    argParser.addArgument(Argument("-v", "--verbose", "verbose", 0, false));
+
+    const char* cargv[] = { "test_program" };
+    char** argv = const_cast<char**>(cargv);
+    // the default memory resource throws and the buffer can't grow, so every
+    // allocation made for the parse must come from the counting resource
+    char buffer[65536];
+    pmr::monotonic_buffer_resource buffered(buffer, sizeof(buffer),
+        pmr::null_memory_resource());
+    CountingResource resource(&buffered);
+    pmr::memory_resource* defaultResource =
+        pmr::set_default_resource(pmr::null_memory_resource());
+    try {
+        ParsedArgument pa = argParser.parse(1, argv, &resource);
+        pmr::set_default_resource(defaultResource);
+
+        // the snapshot of the environment, the mapped file and the values
+        EXPECT_EQ(&resource, pa.getMemoryResource());
+        EXPECT_LT(0u, resource.allocations);
+        EXPECT_LT(strlen("a value that does not fit") +
+            strlen("a log level that does not fit in a small string") +
+            strlen("a host that does not fit in a small string"), resource.bytes);
+        EXPECT_EQ("a value that does not fit", pa.getValue("--a-long-environment-name"));
+        EXPECT_TRUE(pa.hasArgument("--flag"));
+        EXPECT_EQ("a log level that does not fit in a small string", pa.getValue("-l"));
+        EXPECT_EQ(2u, pa.getValues("--hosts").size());
+        EXPECT_EQ("2", pa.getValues("-b")[1]);
+        EXPECT_TRUE(pa.hasArgument("-v"));
+    } catch (...) {
+        pmr::set_default_resource(defaultResource);
+        ADD_FAILURE() << "the default memory resource was used";
+    }
+    remove("cppargparser_test_user.conf");
+    unsetenv("CPPARGPARSER_TEST_A_LONG_ENVIRONMENT_NAME");
+    unsetenv("CPPARGPARSER_TEST_FLAG");
+}
+
+TEST(ArgumentParserTest, ParseWithMemoryResource) {
+    ArgumentParser argParser;
+    argParser.addArgument(Argument("-a", "--aaa", "aaa", 1, true));
+    argParser.addArgument(Argument("-b", "--bbb", "bbb", Argument::INFINITY, false));
+    argParser.addArgument(Argument("-x", "--extract", "extract", 0, false));
+    argParser.addArgument(Argument("-z", "--gzip", "gzip", 0, false));
+
+    const char* cargv[] = {
+        "test_program", "-xz", "-b", "another value that does not fit in a small string",
+        "2", "--aaa=a value that does not fit in a small string"
+    };
+    char** argv = const_cast<char**>(cargv);
+
+    // the default memory resource throws, so every allocation made for the
+    // parse must come from the given memory resource
+    char buffer[16384];
+    pmr::monotonic_buffer_resource resource(buffer, sizeof(buffer),
+        pmr::null_memory_resource());
+    pmr::memory_resource* defaultResource =
+        pmr::set_default_resource(pmr::null_memory_resource());
+    try {
+        ParsedArgument pa = argParser.parse(6, argv, &resource);
+        pmr::set_default_resource(defaultResource);
+
+        EXPECT_EQ(&resource, pa.getMemoryResource());
+        EXPECT_EQ("a value that does not fit in a small string", pa.getValue("-a"));
+        EXPECT_TRUE(pa.hasArgument("--extract"));
+        EXPECT_TRUE(pa.hasArgument("--gzip"));
+        vector<string> args = pa.getValues("--bbb");
+        ASSERT_EQ(2u, args.size());
+        EXPECT_EQ("another value that does not fit in a small string", args[0]);
+    } catch (...) {
+        pmr::set_default_resource(defaultResource);
+        FAIL() << "the default memory resource was used";
+    }
+}
+
+TEST(ArgumentParserTest, GetValuesDoesNotCopy) {
+    ArgumentParser argParser;
+    argParser.addArgument(Argument("-h", "--hhh", "hhh", Argument::INFINITY, true));
+    argParser.addArgument(Argument("-x", "xxx", Argument::SHORT, 0, false));
+
+    const char* cargv[] = { "test_program", "-h", "1", "2", "3", "-x" };
+    char** argv = const_cast<char**>(cargv);
+    ParsedArgument pa = argParser.parse(6, argv);
+
+    ValueList shortValues = pa.getValues("-h");
+    ValueList longValues = pa.getValues("--hhh");
+    ASSERT_EQ(3u, shortValues.size());
+    ASSERT_EQ(3u, longValues.size());
+    EXPECT_EQ(shortValues.view(0).data(), longValues.view(0).data());
+    EXPECT_EQ("1", shortValues.view(0));
+    EXPECT_EQ("3", shortValues[2]);
+    size_t n = 0;
+    for (ValueList::const_iterator i = longValues.begin(); i != longValues.end(); ++i) {
+        ++n;
+    }
+    EXPECT_EQ(3u, n);
+}
+
+TEST(ArgumentParserTest, GetValuesAsStrings) {
+    ArgumentParser argParser;
+    argParser.addArgument(Argument("-h", "--hhh", "hhh", Argument::INFINITY, true));
+
+    const char* cargv[] = { "test_program", "-h", "a value that does not fit in a small string", "2" };
+    char** argv = const_cast<char**>(cargv);
+    ParsedArgument pa = argParser.parse(4, argv);
+
+    // the code written against std::vector<std::string> still compiles
+    std::string s = pa.getValues("-h")[0];
+    const std::string& t = pa.getValues("--hhh")[1];
+    vector<string> v = pa.getValues("-h");
+    EXPECT_EQ("a value that does not fit in a small string", s);
+    EXPECT_EQ("2", t);
+    EXPECT_EQ(v[0], s);
+    EXPECT_EQ(s.size(), pa.getValues("-h")[0].size());
+}
+
+TEST(ArgumentParserTest, TakeValues) {
+    ArgumentParser argParser;
+    argParser.addArgument(Argument("-h", "--hhh", "hhh", Argument::INFINITY, true));
+    argParser.addArgument(Argument("-i", "--iii", "iii", 1, true));
+
+    const char* cargv[] = {
+        "test_program", "-h", "a value that does not fit in a small string", "2",
+        "--iii", "blah"
+    };
+    char** argv = const_cast<char**>(cargv);
+    ParsedArgument pa = argParser.parse(6, argv);
+
+    const char* data = pa.getValues("-h").view(0).data();
+    pmr::vector<pmr::string> values = pa.takeValues("--hhh");
+    ASSERT_EQ(2u, values.size());
+    EXPECT_EQ(data, values[0].data());
+    EXPECT_EQ(pa.getMemoryResource(), values.get_allocator().resource());
+    EXPECT_TRUE(pa.hasArgument("-h"));
+    EXPECT_TRUE(pa.getValues("-h").empty());
+    EXPECT_THROW(pa.getValue("-h"), InvalidArgumentException);
+    EXPECT_EQ("blah", pa.getValue("-i"));
+    EXPECT_THROW(pa.takeValues("--jjj"), InvalidArgumentException);
+}
+
+TEST(ArgumentParserTest, DuplicatePolicy) {
+    ArgumentParser argParser;
+    argParser.addArgument(Argument("-a", "--aaa", "aaa", 1, false));
+    argParser.addArgument(Argument("-f", "--fff", "fff", 1, false)
+        .setDuplicatePolicy(Argument::FIRST_WINS));
+    argParser.addArgument(Argument("-l", "--lll", "lll", Argument::INFINITY, false)
+        .setDuplicatePolicy(Argument::LAST_WINS));
+    argParser.addArgument(Argument("-p", "--ppp", "ppp", 2, false)
+        .setDuplicatePolicy(Argument::APPEND));
+    argParser.addArgument(Argument("-v", "--verbose", "verbose", 0, false)
+        .setDuplicatePolicy(Argument::FIRST_WINS));
+
+    const char* cargv[] = {
+        "test_program", "-f", "1", "-l", "1", "2", "3", "-p", "1", "2",
+        "--fff", "2", "-vv", "--lll", "4", "-p", "3", "4", "--verbose", "-a", "x"
+    };
+    char** argv = const_cast<char**>(cargv);
+    ParsedArgument pa = argParser.parse(21, argv);
+
+    EXPECT_EQ("1", pa.getValue("-f"));
+    EXPECT_EQ(2u, pa.getCount("-f"));
+    ASSERT_EQ(1u, pa.getValues("-l").size());
+    EXPECT_EQ("4", pa.getValue("--lll"));
+    ValueList p = pa.getValues("-p");
+    ASSERT_EQ(4u, p.size());
+    EXPECT_EQ("1", p[0]);
+    EXPECT_EQ("4", p[3]);
+    // the occurrences are counted with every policy
+    EXPECT_EQ(2u, pa.getCount("-l"));
+    EXPECT_EQ(2u, pa.getCount("-p"));
+    EXPECT_EQ(3u, pa.getCount("-v"));
+    EXPECT_EQ(1u, pa.getCount("-a"));
+    EXPECT_EQ(0u, pa.getCount("--zzz"));
+
+    const char* cargv2[] = { "test_program", "-a", "x", "--aaa", "y" };
+    argv = const_cast<char**>(cargv2);
+    EXPECT_THROW(argParser.parse(5, argv), InvalidArgumentException);
+}
+
+TEST(ArgumentParserTest, FlagCount) {
+    pmr::monotonic_buffer_resource resource;
+    ArgumentParser argParser;
+    argParser.addArgument(Argument("-v", "--verbose", "verbose", 0, false)
+        .setDuplicatePolicy(Argument::APPEND));
+    argParser.addArgument(Argument("-q", "", "quiet", 0, false));
+
+    const char* cargv[] = { "test_program", "-vvv", "--verbose", "-q" };
+    char** argv = const_cast<char**>(cargv);
+    ParsedArgument pa = argParser.parse(4, argv, &resource);
+
+    EXPECT_EQ(4u, pa.getCount("--verbose"));
+    EXPECT_EQ(1u, pa.getCount("-q"));
+    ASSERT_EQ(1u, pa.getValues("-v").size());
+    EXPECT_EQ("", pa.getValue("-v"));
+    EXPECT_EQ("", pa.getValue("-q"));
+    pmr::vector<pmr::string> taken = pa.takeValues("-q");
+    EXPECT_EQ(1u, taken.size());
+    EXPECT_EQ(&resource, taken.get_allocator().resource());
+}
+
+TEST(ArgumentParserTest, InvalidVariadicBounds) {
+    Argument argument("-a", "--aaa", "aaa", 1, false);
+    try {
+        argument.setNumArgs(5, 2);
+        FAIL();
+    } catch (const InvalidArgumentException& e) {
+        EXPECT_STREQ("-a can't take 5 to 2 argument(s)", e.what());
+    }
+    EXPECT_THROW(argument.setNumArgs(-2, 3), InvalidArgumentException);
+    EXPECT_THROW(argument.setNumArgs(-1, Argument::INFINITY), InvalidArgumentException);
+    EXPECT_EQ(1, argument.getNumArgs());
+    EXPECT_NO_THROW(argument.setNumArgs(0, 0));
+    EXPECT_NO_THROW(argument.setNumArgs(2, Argument::INFINITY));
+}
+
+TEST(ArgumentParserTest, VariadicBounds) {
+    ArgumentParser argParser;
+    argParser.addArgument(Argument("-a", "--aaa", "aaa", 1, false)
+        .setNumArgs(1, Argument::INFINITY));
+    argParser.addArgument(Argument("-b", "--bbb", "bbb", 1, false)
+        .setNumArgs(2, 3));
+    argParser.addArgument(Argument("-c", "--ccc", "ccc", Argument::INFINITY, false));
+
+    const char* cargv[] = {
+        "test_program", "-b", "1", "2", "3", "-a", "x", "-c", "1", "2"
+    };
+    char** argv = const_cast<char**>(cargv);
+    ParsedArgument pa = argParser.parse(10, argv);
+    EXPECT_EQ(3u, pa.getValues("-b").size());
+    EXPECT_EQ(1u, pa.getValues("-a").size());
+    ValueList c = pa.getValues("--ccc");
+    ASSERT_EQ(2u, c.size());
+    EXPECT_EQ("2", c[1]);
+
+    const char* cargv2[] = { "test_program", "-c" };
+    argv = const_cast<char**>(cargv2);
+    pa = argParser.parse(2, argv);
+    EXPECT_TRUE(pa.getValues("-c").empty());
+
+    const char* cargv3[] = { "test_program", "-c", "1", "-a" };
+    argv = const_cast<char**>(cargv3);
+    EXPECT_THROW(argParser.parse(4, argv), InvalidArgumentException);
+
+    const char* cargv4[] = { "test_program", "-b", "1", "-c" };
+    argv = const_cast<char**>(cargv4);
+    EXPECT_THROW(argParser.parse(4, argv), InvalidArgumentException);
+
+    // the fourth value isn't taken by -b, so it's an invalid argument
+    const char* cargv5[] = { "test_program", "-b", "1", "2", "3", "4" };
+    argv = const_cast<char**>(cargv5);
+    EXPECT_THROW(argParser.parse(6, argv), InvalidArgumentException);
+}
+
+TEST(ArgumentParserTest, PositionalWithoutValues) {
+    ArgumentParser argParser;
+    try {
+        argParser.addArgument(Argument("command", "command", Argument::POSITIONAL, 0, true));
+        FAIL();
+    } catch (const InvalidArgumentException& e) {
+        EXPECT_STREQ("command is an invalid argument, a positional argument must take values",
+            e.what());
+    }
+    EXPECT_THROW(argParser.addArgument(Argument("command", "command",
+        Argument::POSITIONAL, 1, true).setNumArgs(0, 0)), InvalidArgumentException);
+
+    // the rejected arguments aren't mandatory
+    const char* cargv[] = { "test_program" };
+    char** argv = const_cast<char**>(cargv);
+    EXPECT_NO_THROW(argParser.parse(1, argv));
+}
+
+TEST(ArgumentParserTest, Positional) {
+    ArgumentParser argParser;
+    argParser.addArgument(Argument("-v", "--verbose", "verbose", 0, false));
+    argParser.addArgument(Argument("command", "command", Argument::POSITIONAL, 1, true));
+    argParser.addArgument(Argument("pair", "pair", Argument::POSITIONAL, 2, false));
+    argParser.addArgument(Argument("files", "files", Argument::POSITIONAL,
+        Argument::INFINITY, false).setNumArgs(1, 3));
+    EXPECT_THROW(argParser.addArgument(Argument("extra", "extra",
+        Argument::POSITIONAL, 1, false)), InvalidArgumentException);
+
+    const char* cargv[] = {
+        "test_program", "copy", "-v", "a", "b", "x.txt", "-", "z.txt"
+    };
+    char** argv = const_cast<char**>(cargv);
+    ParsedArgument pa = argParser.parse(8, argv);
+    EXPECT_EQ("copy", pa.getValue("command"));
+    ValueList pair = pa.getValues("pair");
+    ASSERT_EQ(2u, pair.size());
+    EXPECT_EQ("b", pair[1]);
+    ValueList files = pa.getValues("files");
+    ASSERT_EQ(3u, files.size());
+    EXPECT_EQ("-", files[1]);
+    EXPECT_EQ(1u, pa.getCount("-v"));
+    EXPECT_NE(string::npos, argParser.getHelp("test_program").find("    files "));
+
+    const char* cargv2[] = { "test_program", "copy", "a", "b", "1", "2", "3", "4" };
+    argv = const_cast<char**>(cargv2);
+    EXPECT_THROW(argParser.parse(8, argv), InvalidArgumentException);
+
+    // pair requires 2 values
+    const char* cargv3[] = { "test_program", "copy", "a" };
+    argv = const_cast<char**>(cargv3);
+    EXPECT_THROW(argParser.parse(3, argv), InvalidArgumentException);
+
+    // command is mandatory
+    const char* cargv4[] = { "test_program", "-v" };
+    argv = const_cast<char**>(cargv4);
+    EXPECT_THROW(argParser.parse(2, argv), InvalidArgumentException);
+}
+
+TEST(ArgumentParserTest, Constraints) {
+    ArgumentParser argParser;
+    argParser.addArgument(Argument("-a", "--aaa", "aaa", 0, false));
+    argParser.addArgument(Argument("-b", "--bbb", "bbb", 1, false));
+    argParser.addArgument(Argument("-x", "--xxx", "xxx", 0, false));
+    argParser.addArgument(Argument("-y", "--yyy", "yyy", 0, false));
+    argParser.addArgument(Argument("--json", "json", Argument::LONG, 0, false));
+    argParser.addArgument(Argument("--yaml", "yaml", Argument::LONG, 0, false));
+    argParser.addArgument(Argument("file", "file", Argument::POSITIONAL, 1, false));
+    argParser.addRequires("-a", "--bbb");
+    argParser.addExcludes("--xxx", "-y");
+    vector<string> group;
+    group.push_back("--json");
+    group.push_back("--yaml");
+    group.push_back("file");
+    argParser.addExactlyOne(group);
+    EXPECT_THROW(argParser.addRequires("-a", "--zzz"), InvalidArgumentException);
+
+    const char* cargv[] = { "test_program", "-a", "-b", "1", "-x", "--json" };
+    char** argv = const_cast<char**>(cargv);
+    EXPECT_NO_THROW(argParser.parse(6, argv));
+
+    const char* cargv2[] = { "test_program", "-y", "file.txt" };
+    argv = const_cast<char**>(cargv2);
+    EXPECT_NO_THROW(argParser.parse(3, argv));
+
+    // -a requires -b
+    const char* cargv3[] = { "test_program", "-a", "--json" };
+    argv = const_cast<char**>(cargv3);
+    EXPECT_THROW(argParser.parse(3, argv), InvalidArgumentException);
+
+    // -x excludes -y
+    const char* cargv4[] = { "test_program", "-xy", "--yaml" };
+    argv = const_cast<char**>(cargv4);
+    EXPECT_THROW(argParser.parse(3, argv), InvalidArgumentException);
+
+    // exactly one of --json, --yaml and file
+    const char* cargv5[] = { "test_program", "--json", "--yaml" };
+    argv = const_cast<char**>(cargv5);
+    EXPECT_THROW(argParser.parse(3, argv), InvalidArgumentException);
+    const char* cargv6[] = { "test_program", "-x" };
+    argv = const_cast<char**>(cargv6);
+    try {
+        argParser.parse(2, argv);
+        FAIL();
+    } catch (const InvalidArgumentException& e) {
+        EXPECT_STREQ("exactly one of [--json, --yaml, file] is required", e.what());
+    }
+}
+
+TEST(ArgumentParserTest, MandatoryBeyondOneWord) {
+    ArgumentParser argParser;
+    for (int i = 0; i < 100; ++i) {
+        argParser.addArgument(Argument("--option" + to_string(i), "option",
+            Argument::LONG, 0, i == 70));
+    }
+    const char* cargv[] = { "test_program", "--option3" };
+    char** argv = const_cast<char**>(cargv);
+    try {
+        argParser.parse(2, argv);
+        FAIL();
+    } catch (const InvalidArgumentException& e) {
+        EXPECT_STREQ("--option70 is a mandatory argument", e.what());
+    }
+    const char* cargv2[] = { "test_program", "--option70" };
+    argv = const_cast<char**>(cargv2);
+    EXPECT_NO_THROW(argParser.parse(2, argv));
+}
+
+TEST(ArgumentParserTest, SharedValidator) {
+    shared_ptr<const Validator> validator = make_shared<PatternValidator>("\\d+");
+    weak_ptr<const Validator> alive = validator;
+    {
+        ArgumentParser argParser1;
+        ArgumentParser argParser2;
+        Argument argument("-p", "--port", "port", 1, true);
+        argument.setValidator(validator);
+        validator.reset();
+        argParser1.addArgument(argument);
+        argParser2.addArgument(argument);
+        EXPECT_FALSE(alive.expired());
+
+        const char* cargv[] = { "test_program", "-p", "80" };
+        char** argv = const_cast<char**>(cargv);
+        EXPECT_EQ("80", argParser1.parse(3, argv).getValue("-p"));
+        const char* cargv2[] = { "test_program", "-p", "http" };
+        argv = const_cast<char**>(cargv2);
+        EXPECT_THROW(argParser2.parse(3, argv), InvalidArgumentException);
+    }
+    EXPECT_TRUE(alive.expired());
+
+    // a raw pointer isn't owned
+    PortNumberValidator port;
+    {
+        Argument argument("-p", "--port", "port", 1, true, &port);
+        EXPECT_EQ(&port, argument.getValidator());
+    }
+    EXPECT_TRUE(port.validate(vector<string>(1, "80")));
+}
+
+namespace {
+
+class SlowValidator : public Validator {
+public:
+    SlowValidator() : calls(0) {}
+
+    bool validate(const vector<string>& values) const {
+        ++calls;
+        return values.empty() || values[0].compare(0, 3, "bad") != 0;
+    }
+
+    mutable atomic<int> calls;
+};
+
+class ThrowingValidator : public Validator {
+public:
+    bool validate(const vector<string>& values) const {
+        if (!values.empty() && values[0] == "boom") {
+            throw runtime_error("validator failed");
+        }
+        return values.empty() || values[0].compare(0, 3, "bad") != 0;
+    }
+};
+
+}
+
+TEST(ArgumentParserTest, DeferredValidation) {
+    SlowValidator validator;
+    ArgumentParser argParser;
+    argParser.setValidationThreads(4);
+    for (int i = 0; i < 10; ++i) {
+        argParser.addArgument(Argument("--option" + to_string(i), "option",
+            Argument::LONG, 1, false, &validator));
+    }
+    argParser.addArgument(Argument("-l", "--list", "list", 1, false, &validator)
+        .setDuplicatePolicy(Argument::APPEND));
+
+    const char* cargv[] = {
+        "test_program", "--option3", "a", "-l", "b", "--option1", "c", "-l", "d"
+    };
+    char** argv = const_cast<char**>(cargv);
+    ParsedArgument pa = argParser.parse(9, argv);
+    EXPECT_EQ("c", pa.getValue("--option1"));
+    EXPECT_EQ(2u, pa.getValues("-l").size());
+    // each argument is validated once, after all the values are collected
+    EXPECT_EQ(3, validator.calls.load());
+
+    const char* cargv2[] = {
+        "test_program", "--option9", "bad9", "--option2", "ok", "--option0", "bad0"
+    };
+    argv = const_cast<char**>(cargv2);
+    try {
+        argParser.parse(7, argv);
+        FAIL();
+    } catch (const InvalidArgumentException& e) {
+        EXPECT_STREQ("[bad9] is an invalid argument value\n"
+            "[bad0] is an invalid argument value", e.what());
+    }
+}
+
+TEST(ArgumentParserTest, DeferredValidationOtherException) {
+    ThrowingValidator validator;
+    ArgumentParser argParser;
+    argParser.setValidationThreads(2);
+    for (int i = 0; i < 3; ++i) {
+        argParser.addArgument(Argument("--option" + to_string(i), "option",
+            Argument::LONG, 1, false, &validator));
+    }
+
+    // the only error is rethrown as is
+    const char* cargv[] = { "test_program", "--option0", "boom", "--option1", "ok" };
+    char** argv = const_cast<char**>(cargv);
+    EXPECT_THROW(argParser.parse(5, argv), runtime_error);
+
+    // all the validations finish and the errors are reported together
+    const char* cargv2[] = {
+        "test_program", "--option2", "bad2", "--option0", "boom", "--option1", "bad1"
+    };
+    argv = const_cast<char**>(cargv2);
+    try {
+        argParser.parse(7, argv);
+        FAIL();
+    } catch (const InvalidArgumentException& e) {
+        EXPECT_STREQ("[bad2] is an invalid argument value\n"
+            "validator failed\n"
+            "[bad1] is an invalid argument value", e.what());
+    }
+}
@@ -0,0 +1,163 @@
+// Copyright 2012, Fredy Wijaya
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the Lesser GNU General Public License as published by
+// the Free Software Foundation, either version 3.0 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// Lesser GNU General Public License for more details.
+//
+// You should have received a copy of the Lesser GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>
+
+#include <gtest/gtest.h>
+#include "CachingValidator.h"
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace testing;
+using namespace cppargparser;
+
+namespace {
+
+class CountingValidator : public Validator {
+public:
+    CountingValidator() : calls(0) {}
+
+    bool validate(const vector<string>& values) const {
+        ++calls;
+        return values.size() == 1 && values[0].find(':') != string::npos;
+    }
+
+    mutable int calls;
+};
+
+class HostPortValidator : public Validator {
+public:
+    bool validate(const vector<string>& values) const {
+        return values.size() == 1 && values[0].find(':') != string::npos;
+    }
+};
+
+}
+
+TEST(CachingValidatorTest, CachesResults) {
+    CountingValidator counting;
+    CachingValidator validator(&counting);
+    vector<string> valid(1, "localhost:8080");
+    vector<string> invalid(1, "localhost");
+
+    EXPECT_TRUE(validator.validate(valid));
+    EXPECT_FALSE(validator.validate(invalid));
+    EXPECT_TRUE(validator.validate(valid));
+    EXPECT_FALSE(validator.validate(invalid));
+    EXPECT_EQ(2, counting.calls);
+}
+
+TEST(CachingValidatorTest, KeyedByValueBytes) {
+    CountingValidator counting;
+    CachingValidator validator(&counting);
+    vector<string> one(1, "a:b");
+    vector<string> two;
+    two.push_back("a:");
+    two.push_back("b");
+
+    EXPECT_TRUE(validator.validate(one));
+    EXPECT_FALSE(validator.validate(two));
+    EXPECT_EQ(2, counting.calls);
+}
+
+TEST(CachingValidatorTest, BoundedSize) {
+    CountingValidator counting;
+    CachingValidator validator(&counting, 4);
+    for (int i = 0; i < 100; ++i) {
+        vector<string> values(1, "host:" + to_string(i));
+        EXPECT_TRUE(validator.validate(values));
+    }
+    EXPECT_EQ(100, counting.calls);
+    vector<string> last(1, "host:99");
+    EXPECT_TRUE(validator.validate(last));
+    EXPECT_EQ(100, counting.calls);
+}
+
+TEST(CachingValidatorTest, SharedSlot) {
+    CountingValidator counting;
+    // a single slot, so that all the values collide
+    CachingValidator validator(&counting, 1);
+    vector<string> valid(1, "localhost:8080");
+    vector<string> invalid(1, "localhost");
+
+    EXPECT_TRUE(validator.validate(valid));
+    EXPECT_FALSE(validator.validate(invalid));
+    EXPECT_FALSE(validator.validate(invalid));
+    EXPECT_TRUE(validator.validate(valid));
+    EXPECT_TRUE(validator.validate(valid));
+    EXPECT_EQ(3, counting.calls);
+}
+
+TEST(CachingValidatorTest, LongValuesNotCached) {
+    CountingValidator counting;
+    CachingValidator validator(&counting);
+    vector<string> values(1, string(CachingValidator::MAX_CACHED_LENGTH, 'a') + ":1");
+
+    EXPECT_TRUE(validator.validate(values));
+    EXPECT_TRUE(validator.validate(values));
+    EXPECT_EQ(2, counting.calls);
+}
+
+TEST(CachingValidatorTest, ConcurrentValidate) {
+    CountingValidator counting;
+    CachingValidator validator(&counting);
+    vector<string> valid(1, "localhost:8080");
+    // warm the cache so that the threads only read it
+    validator.validate(valid);
+    vector<thread> threads;
+    bool results[4] = { false, false, false, false };
+    for (int t = 0; t < 4; ++t) {
+        threads.push_back(thread([&validator, &valid, &results, t]() {
+            bool ok = true;
+            for (int i = 0; i < 1000; ++i) {
+                ok = ok && validator.validate(valid);
+            }
+            results[t] = ok;
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); ++t) {
+        threads[t].join();
+    }
+    for (int t = 0; t < 4; ++t) {
+        EXPECT_TRUE(results[t]);
+    }
+    EXPECT_EQ(1, counting.calls);
+}
+
+TEST(CachingValidatorTest, ConcurrentValidateSharedSlot) {
+    HostPortValidator hostPort;
+    CachingValidator validator(&hostPort, 1);
+    vector<string> valid(1, "localhost:8080");
+    vector<string> invalid(1, "localhost");
+    vector<thread> threads;
+    bool results[4] = { false, false, false, false };
+    for (int t = 0; t < 4; ++t) {
+        threads.push_back(thread([&validator, &valid, &invalid, &results, t]() {
+            bool ok = true;
+            for (int i = 0; i < 1000; ++i) {
+                // the threads keep replacing each other's results
+                bool expected = (i + t) % 2 == 0;
+                ok = ok && validator.validate(expected ? valid : invalid) == expected;
+            }
+            results[t] = ok;
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); ++t) {
+        threads[t].join();
+    }
+    for (int t = 0; t < 4; ++t) {
+        EXPECT_TRUE(results[t]);
+    }
+}
@@ -0,0 +1,113 @@
+// Copyright 2012, Fredy Wijaya
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the Lesser GNU General Public License as published by
+// the Free Software Foundation, either version 3.0 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// Lesser GNU General Public License for more details.
+//
+// You should have received a copy of the Lesser GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>
+
+#include <gtest/gtest.h>
+#include "ConfigFile.h"
+#include "InvalidArgumentException.h"
+#include <cstdio>
+#include <fstream>
+
+using namespace std;
+using namespace testing;
+using namespace cppargparser;
+
+namespace {
+
+void writeFile(const string& path, const string& content) {
+    ofstream out(path.c_str());
+    out << content;
+}
+
+}
+
+TEST(ConfigFileTest, ReadEntries) {
+    string path = "cppargparser_config_file_test.conf";
+    writeFile(path,
+        "# comment\n"
+        "; another comment\n"
+        "\n"
+        "log-level = debug\n"
+        "  name=\"quoted # value\"  # trailing comment\r\n"
+        "hosts = [\"foo\", bar , 'baz qux']\n"
+        "[server]\n"
+        "port = 8888\n"
+        "[]\n"
+        "empty =");
+    ConfigFile file(path);
+    remove(path.c_str());
+
+    EXPECT_TRUE(file.isOpen());
+    const pmr::vector<ConfigFile::Entry>& entries = file.getEntries();
+    ASSERT_EQ(5u, entries.size());
+
+    string key;
+    vector<string> values;
+    ConfigFile::getKey(entries[0], key);
+    ConfigFile::getValues(entries[0], values);
+    EXPECT_EQ("log-level", key);
+    EXPECT_EQ(4, entries[0].line);
+    ASSERT_EQ(1u, values.size());
+    EXPECT_EQ("debug", values[0]);
+
+    values.clear();
+    ConfigFile::getKey(entries[1], key);
+    ConfigFile::getValues(entries[1], values);
+    EXPECT_EQ("name", key);
+    ASSERT_EQ(1u, values.size());
+    EXPECT_EQ("quoted # value", values[0]);
+
+    values.clear();
+    ConfigFile::getValues(entries[2], values);
+    ASSERT_EQ(3u, values.size());
+    EXPECT_EQ("foo", values[0]);
+    EXPECT_EQ("bar", values[1]);
+    EXPECT_EQ("baz qux", values[2]);
+
+    values.clear();
+    ConfigFile::getKey(entries[3], key);
+    ConfigFile::getValues(entries[3], values);
+    EXPECT_EQ("server.port", key);
+    EXPECT_EQ("8888", values[0]);
+
+    values.clear();
+    ConfigFile::getKey(entries[4], key);
+    ConfigFile::getValues(entries[4], values);
+    EXPECT_EQ("empty", key);
+    ASSERT_EQ(1u, values.size());
+    EXPECT_EQ("", values[0]);
+}
+
+TEST(ConfigFileTest, ReadMissingFile) {
+    ConfigFile file("cppargparser_config_file_test_missing.conf");
+    EXPECT_FALSE(file.isOpen());
+    EXPECT_TRUE(file.getEntries().empty());
+}
+
+TEST(ConfigFileTest, ReadEmptyFile) {
+    string path = "cppargparser_config_file_test.conf";
+    writeFile(path, "");
+    ConfigFile file(path);
+    remove(path.c_str());
+
+    EXPECT_TRUE(file.isOpen());
+    EXPECT_TRUE(file.getEntries().empty());
+}
+
+TEST(ConfigFileTest, ReadInvalidLine) {
+    string path = "cppargparser_config_file_test.conf";
+    writeFile(path, "a = 1\nwhatever\n");
+    EXPECT_THROW(ConfigFile file(path), InvalidArgumentException);
+    remove(path.c_str());
+}
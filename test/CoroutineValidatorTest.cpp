@@ -0,0 +1,162 @@
+// Copyright 2012, Fredy Wijaya
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the Lesser GNU General Public License as published by
+// the Free Software Foundation, either version 3.0 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// Lesser GNU General Public License for more details.
+//
+// You should have received a copy of the Lesser GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>
+
+// the coroutine validators need C++20, see TEST_CCFLAGS in the makefiles
+#if __cplusplus >= 202002L
+
+#include <gtest/gtest.h>
+#include "ArgumentParser.h"
+#include "CoroutineValidator.h"
+#include "InvalidArgumentException.h"
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace std;
+using namespace testing;
+using namespace cppargparser;
+
+namespace {
+
+// a stub for asynchronous checks, the suspended coroutines are resumed by
+// another thread, like an I/O thread would
+class StubChecks {
+public:
+    struct Awaiter {
+        StubChecks* checks;
+        string value;
+        bool result;
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        void await_suspend(coroutine_handle<> handle) {
+            checks->suspend(this, handle);
+        }
+
+        bool await_resume() const noexcept {
+            return result;
+        }
+    };
+
+    StubChecks() : maxPending(0) {}
+
+    Awaiter exists(const string& value) {
+        Awaiter awaiter = { this, value, false };
+        return awaiter;
+    }
+
+    // resumes the pending checks once there are n of them, or after a
+    // timeout so that a parser awaiting the checks one by one doesn't hang
+    void resumeWhenPending(size_t n) {
+        vector<pair<Awaiter*, coroutine_handle<> > > resumed;
+        {
+            unique_lock<mutex> lock(m);
+            cv.wait_for(lock, chrono::seconds(5), [&]() { return pending.size() >= n; });
+            resumed.swap(pending);
+        }
+        for (size_t i = 0; i < resumed.size(); ++i) {
+            resumed[i].first->result = resumed[i].first->value != "missing";
+            resumed[i].second.resume();
+        }
+    }
+
+    size_t maxPending;
+
+private:
+    void suspend(Awaiter* awaiter, coroutine_handle<> handle) {
+        lock_guard<mutex> lock(m);
+        pending.push_back(make_pair(awaiter, handle));
+        maxPending = max(maxPending, pending.size());
+        cv.notify_all();
+    }
+
+    mutex m;
+    condition_variable cv;
+    vector<pair<Awaiter*, coroutine_handle<> > > pending;
+};
+
+class PathValidator : public CoroutineValidator {
+public:
+    PathValidator(StubChecks* _checks) : checks(_checks) {}
+
+    ValidationTask check(vector<string> values) const {
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (!co_await checks->exists(values[i])) {
+                co_return false;
+            }
+        }
+        co_return true;
+    }
+
+private:
+    StubChecks* checks;
+};
+
+}
+
+TEST(CoroutineValidatorTest, StartsAllChecksBeforeWaiting) {
+    StubChecks checks;
+    PathValidator validator(&checks);
+    ArgumentParser argParser;
+    argParser.setValidationThreads(1);
+    argParser.addArgument(Argument("-a", "--aaa", "aaa", 1, true, &validator));
+    argParser.addArgument(Argument("-b", "--bbb", "bbb", 1, true, &validator));
+    argParser.addArgument(Argument("-c", "--ccc", "ccc", 1, true, &validator));
+
+    const char* cargv[] = { "test_program", "-a", "a.txt", "-b", "b.txt", "-c", "c.txt" };
+    char** argv = const_cast<char**>(cargv);
+    thread io(&StubChecks::resumeWhenPending, &checks, 3);
+    ParsedArgument pa = argParser.parse(7, argv);
+    io.join();
+    EXPECT_EQ(3u, checks.maxPending);
+    EXPECT_EQ("b.txt", pa.getValue("-b"));
+}
+
+TEST(CoroutineValidatorTest, ReportsInvalidValues) {
+    StubChecks checks;
+    PathValidator validator(&checks);
+    ArgumentParser argParser;
+    argParser.setValidationThreads(1);
+    argParser.addArgument(Argument("-a", "--aaa", "aaa", 1, true, &validator));
+    argParser.addArgument(Argument("-b", "--bbb", "bbb", 1, true, &validator));
+
+    const char* cargv[] = { "test_program", "-b", "missing", "-a", "a.txt" };
+    char** argv = const_cast<char**>(cargv);
+    thread io(&StubChecks::resumeWhenPending, &checks, 2);
+    try {
+        argParser.parse(5, argv);
+        FAIL();
+    } catch (const InvalidArgumentException& e) {
+        EXPECT_STREQ("[missing] is an invalid argument value", e.what());
+    }
+    io.join();
+}
+
+TEST(CoroutineValidatorTest, ValidateWaits) {
+    StubChecks checks;
+    PathValidator validator(&checks);
+    thread io(&StubChecks::resumeWhenPending, &checks, 1);
+    EXPECT_TRUE(validator.validate(vector<string>(1, "a.txt")));
+    io.join();
+}
+
+#endif
@@ -0,0 +1,84 @@
+// Copyright 2012, Fredy Wijaya
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the Lesser GNU General Public License as published by
+// the Free Software Foundation, either version 3.0 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// Lesser GNU General Public License for more details.
+//
+// You should have received a copy of the Lesser GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>
+
+#include <gtest/gtest.h>
+#include "LongArgumentIndex.h"
+#include <sstream>
+
+using namespace std;
+using namespace testing;
+using namespace cppargparser;
+
+TEST(LongArgumentIndexTest, FindExactMatch) {
+    LongArgumentIndex index;
+    index.add("--verbose", 0);
+    index.add("--version", 1);
+    index.add("--verb", 2);
+
+    EXPECT_EQ(0, index.find("--verbose"));
+    EXPECT_EQ(1, index.find("--version"));
+    EXPECT_EQ(2, index.find("--verb"));
+}
+
+TEST(LongArgumentIndexTest, FindUniquePrefix) {
+    LongArgumentIndex index;
+    index.add("--verbose", 0);
+    index.add("--version", 1);
+    index.add("--help", 2);
+
+    EXPECT_EQ(0, index.find("--verbo"));
+    EXPECT_EQ(1, index.find("--versi"));
+    EXPECT_EQ(2, index.find("--h"));
+    EXPECT_EQ(LongArgumentIndex::AMBIGUOUS, index.find("--ver"));
+    EXPECT_EQ(LongArgumentIndex::AMBIGUOUS, index.find("--"));
+    EXPECT_EQ(LongArgumentIndex::NOT_FOUND, index.find("--verbosity"));
+    EXPECT_EQ(LongArgumentIndex::NOT_FOUND, index.find("--x"));
+}
+
+TEST(LongArgumentIndexTest, FindEmptyIndex) {
+    LongArgumentIndex index;
+    EXPECT_EQ(LongArgumentIndex::NOT_FOUND, index.find("--verbose"));
+
+    index.add("--verbose", 0);
+    index.clear();
+    EXPECT_EQ(LongArgumentIndex::NOT_FOUND, index.find("--verbose"));
+}
+
+TEST(LongArgumentIndexTest, AddSameNameTwice) {
+    LongArgumentIndex index;
+    index.add("--verbose", 0);
+    index.add("--verbose", 1);
+
+    EXPECT_EQ(0, index.find("--verbose"));
+    EXPECT_EQ(0, index.find("--v"));
+    EXPECT_EQ(0, index.find("--verb"));
+}
+
+TEST(LongArgumentIndexTest, FindManyNames) {
+    LongArgumentIndex index;
+    for (int i = 0; i < 1000; ++i) {
+        ostringstream oss;
+        oss << "--option" << i << "-name";
+        index.add(oss.str(), i);
+    }
+    for (int i = 0; i < 1000; ++i) {
+        ostringstream oss;
+        oss << "--option" << i << "-name";
+        EXPECT_EQ(i, index.find(oss.str()));
+        EXPECT_EQ(i, index.find(oss.str().substr(0, oss.str().size() - 3)));
+    }
+    EXPECT_EQ(LongArgumentIndex::AMBIGUOUS, index.find("--option1"));
+    EXPECT_EQ(LongArgumentIndex::NOT_FOUND, index.find("--option1000"));
+}
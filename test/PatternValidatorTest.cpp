@@ -0,0 +1,177 @@
+// Copyright 2012, Fredy Wijaya
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the Lesser GNU General Public License as published by
+// the Free Software Foundation, either version 3.0 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// Lesser GNU General Public License for more details.
+//
+// You should have received a copy of the Lesser GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>
+
+#include <gtest/gtest.h>
+#include "PatternValidator.h"
+#include "InvalidArgumentException.h"
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace testing;
+using namespace cppargparser;
+
+TEST(PatternValidatorTest, Literals) {
+    PatternValidator validator("abc");
+    EXPECT_TRUE(validator.matches("abc"));
+    EXPECT_FALSE(validator.matches("ab"));
+    EXPECT_FALSE(validator.matches("abcd"));
+    EXPECT_FALSE(validator.matches(""));
+}
+
+TEST(PatternValidatorTest, ClassesAndQuantifiers) {
+    PatternValidator validator("[a-z0-9.-]+:\\d{1,5}");
+    EXPECT_TRUE(validator.matches("localhost:8080"));
+    EXPECT_TRUE(validator.matches("my-host.example.com:1"));
+    EXPECT_FALSE(validator.matches("localhost:"));
+    EXPECT_FALSE(validator.matches("localhost:123456"));
+    EXPECT_FALSE(validator.matches("Localhost:80"));
+
+    PatternValidator optional("-?\\d+(\\.\\d*)?");
+    EXPECT_TRUE(optional.matches("-1.5"));
+    EXPECT_TRUE(optional.matches("42"));
+    EXPECT_TRUE(optional.matches("42."));
+    EXPECT_FALSE(optional.matches("4a"));
+
+    PatternValidator negated("[^,]*");
+    EXPECT_TRUE(negated.matches("a b"));
+    EXPECT_FALSE(negated.matches("a,b"));
+
+    PatternValidator atLeast("(ab){2,}");
+    EXPECT_FALSE(atLeast.matches("ab"));
+    EXPECT_TRUE(atLeast.matches("abab"));
+    EXPECT_TRUE(atLeast.matches("ababab"));
+
+    PatternValidator exactly("x{3}");
+    EXPECT_FALSE(exactly.matches("xx"));
+    EXPECT_TRUE(exactly.matches("xxx"));
+    EXPECT_FALSE(exactly.matches("xxxx"));
+}
+
+TEST(PatternValidatorTest, Alternation) {
+    PatternValidator validator("debug|info|warn(ing)?|error|");
+    EXPECT_TRUE(validator.matches("info"));
+    EXPECT_TRUE(validator.matches("warn"));
+    EXPECT_TRUE(validator.matches("warning"));
+    EXPECT_TRUE(validator.matches(""));
+    EXPECT_FALSE(validator.matches("trace"));
+}
+
+TEST(PatternValidatorTest, Validate) {
+    PatternValidator validator("\\w+");
+    vector<string> values;
+    values.push_back("a_1");
+    values.push_back("b");
+    EXPECT_TRUE(validator.validate(values));
+    values.push_back("c d");
+    EXPECT_FALSE(validator.validate(values));
+    EXPECT_EQ("\\w+", validator.getPattern());
+}
+
+TEST(PatternValidatorTest, InvalidPattern) {
+    EXPECT_THROW(PatternValidator("(ab"), InvalidArgumentException);
+    EXPECT_THROW(PatternValidator("ab)"), InvalidArgumentException);
+    EXPECT_THROW(PatternValidator("[ab"), InvalidArgumentException);
+    EXPECT_THROW(PatternValidator("*a"), InvalidArgumentException);
+    EXPECT_THROW(PatternValidator("a{3,2}"), InvalidArgumentException);
+    EXPECT_THROW(PatternValidator("[z-a]"), InvalidArgumentException);
+}
+
+TEST(PatternValidatorTest, Escapes) {
+    PatternValidator tab("a\\tb");
+    EXPECT_TRUE(tab.matches("a\tb"));
+    EXPECT_FALSE(tab.matches("atb"));
+
+    PatternValidator hex("\\x41");
+    EXPECT_TRUE(hex.matches("A"));
+    EXPECT_FALSE(hex.matches("x41"));
+
+    PatternValidator controls("\\n\\r\\f\\v\\0");
+    EXPECT_TRUE(controls.matches(string("\n\r\f\v\0", 5)));
+
+    PatternValidator backspace("[\\b]");
+    EXPECT_TRUE(backspace.matches("\b"));
+    EXPECT_FALSE(backspace.matches("b"));
+
+    PatternValidator punctuation("\\.\\-");
+    EXPECT_TRUE(punctuation.matches(".-"));
+}
+
+TEST(PatternValidatorTest, EscapedRanges) {
+    PatternValidator controls("[\\x00-\\x1f]");
+    EXPECT_TRUE(controls.matches("\x05"));
+    EXPECT_TRUE(controls.matches(string(1, '\0')));
+    EXPECT_FALSE(controls.matches("-"));
+    EXPECT_FALSE(controls.matches(" "));
+
+    PatternValidator spaces("[\\t-\\r]+");
+    EXPECT_TRUE(spaces.matches("\t\n\v\f\r"));
+    EXPECT_FALSE(spaces.matches("-"));
+
+    PatternValidator mixed("[!-\\/]");
+    EXPECT_TRUE(mixed.matches("/"));
+    EXPECT_TRUE(mixed.matches("#"));
+    EXPECT_FALSE(mixed.matches("0"));
+
+    PatternValidator trailing("[\\d-]+");
+    EXPECT_TRUE(trailing.matches("1-2"));
+}
+
+TEST(PatternValidatorTest, ClassEscapeInRange) {
+    EXPECT_THROW(PatternValidator("[\\d-z]"), InvalidArgumentException);
+    EXPECT_THROW(PatternValidator("[a-\\w]"), InvalidArgumentException);
+    EXPECT_THROW(PatternValidator("[\\x1f-\\x00]"), InvalidArgumentException);
+}
+
+TEST(PatternValidatorTest, InvalidEscapes) {
+    EXPECT_THROW(PatternValidator("(a)\\1"), InvalidArgumentException);
+    EXPECT_THROW(PatternValidator("a\\b"), InvalidArgumentException);
+    EXPECT_THROW(PatternValidator("a\\B"), InvalidArgumentException);
+    EXPECT_THROW(PatternValidator("\\q"), InvalidArgumentException);
+    EXPECT_THROW(PatternValidator("\\x4"), InvalidArgumentException);
+    EXPECT_THROW(PatternValidator("\\01"), InvalidArgumentException);
+    EXPECT_THROW(PatternValidator("[\\1]"), InvalidArgumentException);
+}
+
+TEST(PatternValidatorTest, DotExcludesLineTerminators) {
+    PatternValidator validator("a.b");
+    EXPECT_TRUE(validator.matches("a b"));
+    EXPECT_FALSE(validator.matches("a\nb"));
+    EXPECT_FALSE(validator.matches("a\rb"));
+    EXPECT_FALSE(PatternValidator(".").matches("\n"));
+}
+
+TEST(PatternValidatorTest, ConcurrentMatches) {
+    const PatternValidator validator("(\\d{1,3}\\.){3}\\d{1,3}");
+    vector<thread> threads;
+    int failures[4] = { 0, 0, 0, 0 };
+    for (int t = 0; t < 4; ++t) {
+        threads.push_back(thread([&validator, &failures, t]() {
+            for (int i = 0; i < 1000; ++i) {
+                if (!validator.matches("192.168.0." + to_string(i % 256)) ||
+                    validator.matches("192.168.0")) {
+                    ++failures[t];
+                }
+            }
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); ++t) {
+        threads[t].join();
+    }
+    for (int t = 0; t < 4; ++t) {
+        EXPECT_EQ(0, failures[t]);
+    }
+}
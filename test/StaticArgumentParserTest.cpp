@@ -0,0 +1,104 @@
+// Copyright 2012, Fredy Wijaya
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the Lesser GNU General Public License as published by
+// the Free Software Foundation, either version 3.0 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// Lesser GNU General Public License for more details.
+//
+// You should have received a copy of the Lesser GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>
+
+#include <gtest/gtest.h>
+#include "StaticArgumentParser.h"
+#include "InvalidArgumentException.h"
+
+using namespace std;
+using namespace testing;
+using namespace cppargparser;
+
+namespace {
+
+constexpr StaticArgument arguments[] = {
+    { "-a", "--aaa", "aaa description", 1, true },
+    { "-b", "", "bbb description", 0, false },
+    { "", "--a-very-long-argument-name-that-does-not-fit-in-forty-columns",
+        "long description", 0, false }
+};
+
+typedef StaticArgumentParser<arguments> TestArgumentParser;
+
+class BuildArgumentParserFactory : public ArgumentParserFactory {
+public:
+    ArgumentParser* create() const {
+        ArgumentParser* argParser = new ArgumentParser();
+        argParser->addArgument(Argument("--target", "target", Argument::LONG, 1, true));
+        return argParser;
+    }
+};
+
+const BuildArgumentParserFactory buildFactory;
+
+constexpr StaticSubcommand subcommands[] = {
+    { "build", "build a target", &buildFactory },
+    { "a-subcommand-name-longer-than-the-options", "long", &buildFactory }
+};
+
+typedef StaticArgumentParser<arguments, subcommands> SubcommandArgumentParser;
+
+static_assert(TestArgumentParser::HELP[0] == 'O',
+    "the help menu must be rendered at compile time");
+
+}
+
+TEST(StaticArgumentParserTest, HelpMatchesRuntimeHelp) {
+    TestArgumentParser argParser;
+    string help(TestArgumentParser::HELP.data(),
+        TestArgumentParser::HELP.size());
+
+    EXPECT_EQ(argParser.getHelp("test_program"), "Usage: test_program\n" + help);
+}
+
+TEST(StaticArgumentParserTest, ShowHelp) {
+    TestArgumentParser argParser;
+
+    internal::CaptureStdout();
+    argParser.showHelp("test_program");
+    EXPECT_EQ(argParser.getHelp("test_program"), internal::GetCapturedStdout());
+}
+
+TEST(StaticArgumentParserTest, Parse) {
+    TestArgumentParser argParser;
+
+    const char* cargv[] = { "test_program", "--aaa=1", "-b" };
+    char** argv = const_cast<char**>(cargv);
+    ParsedArgument pa = argParser.parse(3, argv);
+
+    EXPECT_EQ("1", pa.getValue("-a"));
+    EXPECT_TRUE(pa.hasArgument("-b"));
+
+    TestArgumentParser missingMandatory;
+    EXPECT_THROW(missingMandatory.parse(1, argv), InvalidArgumentException);
+}
+
+TEST(StaticArgumentParserTest, Subcommands) {
+    SubcommandArgumentParser argParser;
+    string help(SubcommandArgumentParser::HELP.data(),
+        SubcommandArgumentParser::HELP.size());
+    EXPECT_EQ(argParser.getHelp("test_program"), "Usage: test_program\n" + help);
+    EXPECT_NE(string::npos, help.find("Commands:\n    build "));
+
+    internal::CaptureStdout();
+    argParser.showHelp("test_program");
+    EXPECT_EQ(argParser.getHelp("test_program"), internal::GetCapturedStdout());
+
+    const char* cargv[] = { "test_program", "-a", "1", "build", "--target", "all" };
+    char** argv = const_cast<char**>(cargv);
+    ParsedArgument pa = argParser.parse(6, argv);
+    EXPECT_EQ("build", pa.getSubcommand());
+    EXPECT_EQ("all", pa.getValue("--target"));
+}
@@ -0,0 +1,92 @@
+// Copyright 2012, Fredy Wijaya
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the Lesser GNU General Public License as published by
+// the Free Software Foundation, either version 3.0 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// Lesser GNU General Public License for more details.
+//
+// You should have received a copy of the Lesser GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>
+
+#include <gtest/gtest.h>
+#include "StringPool.h"
+#include <string>
+
+using namespace std;
+using namespace testing;
+using namespace cppargparser;
+
+TEST(StringPoolTest, Intern) {
+    StringPool pool;
+    uint32_t port = pool.intern("--port");
+    uint32_t host = pool.intern("--host");
+    EXPECT_EQ(0u, port);
+    EXPECT_EQ(1u, host);
+    EXPECT_EQ(port, pool.intern(string("--port")));
+    EXPECT_EQ(2u, pool.size());
+    EXPECT_EQ(12u, pool.getBytes());
+    EXPECT_EQ("--port", pool.get(port));
+    EXPECT_EQ("--host", pool.get(host));
+}
+
+TEST(StringPoolTest, Find) {
+    StringPool pool;
+    uint32_t port = pool.intern("--port");
+    EXPECT_EQ(port, pool.find("--port"));
+    EXPECT_EQ(StringPool::NOT_FOUND, pool.find("--po"));
+    EXPECT_EQ(StringPool::NOT_FOUND, pool.find("--ports"));
+    EXPECT_EQ(1u, pool.size());
+}
+
+TEST(StringPoolTest, EmptyString) {
+    StringPool pool;
+    uint32_t empty = pool.intern("");
+    EXPECT_EQ("", pool.get(empty));
+    EXPECT_EQ(empty, pool.find(""));
+}
+
+TEST(StringPoolTest, StableViews) {
+    StringPool pool;
+    string_view first = pool.get(pool.intern("first"));
+    // more than one chunk, including a string longer than a chunk
+    for (int i = 0; i < 2000; ++i) {
+        pool.intern("string " + to_string(i));
+    }
+    uint32_t large = pool.intern(string(10000, 'x'));
+    EXPECT_EQ("first", first);
+    EXPECT_EQ(string(10000, 'x'), pool.get(large));
+    EXPECT_EQ(1u, pool.find("string 0"));
+    EXPECT_EQ(2000u, pool.find("string 1999"));
+}
+
+TEST(StringPoolTest, Grow) {
+    StringPool pool;
+    // the table grows many times while the ids stay the same
+    for (int i = 0; i < 5000; ++i) {
+        EXPECT_EQ(static_cast<uint32_t>(i), pool.intern(to_string(i)));
+    }
+    for (int i = 0; i < 5000; ++i) {
+        EXPECT_EQ(static_cast<uint32_t>(i), pool.find(to_string(i)));
+        EXPECT_EQ(static_cast<uint32_t>(i), pool.intern(to_string(i)));
+    }
+    EXPECT_EQ(StringPool::NOT_FOUND, pool.find("5000"));
+    EXPECT_EQ(5000u, pool.size());
+}
+
+TEST(StringPoolTest, Copy) {
+    StringPool pool;
+    pool.intern("--port");
+    pool.intern("--host");
+    StringPool copy(pool);
+    pool = StringPool();
+    EXPECT_EQ(0u, pool.size());
+    EXPECT_EQ(1u, copy.find("--host"));
+    EXPECT_EQ("--port", copy.get(0));
+    pool = copy;
+    EXPECT_EQ(1u, pool.find("--host"));
+}
@@ -0,0 +1,82 @@
+// Copyright 2012, Fredy Wijaya
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the Lesser GNU General Public License as published by
+// the Free Software Foundation, either version 3.0 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// Lesser GNU General Public License for more details.
+//
+// You should have received a copy of the Lesser GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>
+
+#include <gtest/gtest.h>
+#include "ValidatorPipeline.h"
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace testing;
+using namespace cppargparser;
+
+namespace {
+
+class PrefixValidator : public Validator {
+public:
+    PrefixValidator(const string& _prefix) : prefix(_prefix), calls(0) {}
+
+    bool validate(const vector<string>& values) const {
+        ++calls;
+        return !values.empty() && values[0].compare(0, prefix.size(), prefix) == 0;
+    }
+
+    string prefix;
+    mutable int calls;
+};
+
+}
+
+TEST(ValidatorPipelineTest, OrderedByCost) {
+    PrefixValidator expensive("a");
+    PrefixValidator cheap("ab");
+    PrefixValidator cheapest("");
+    ValidatorPipeline pipeline;
+    pipeline.add(&expensive, 100).add(&cheap, 10).add(&cheapest, 10);
+
+    ASSERT_EQ(3u, pipeline.size());
+    EXPECT_EQ(&cheap, pipeline.getValidator(0));
+    EXPECT_EQ(&cheapest, pipeline.getValidator(1));
+    EXPECT_EQ(&expensive, pipeline.getValidator(2));
+    EXPECT_EQ(100u, pipeline.getStats(2).cost);
+}
+
+TEST(ValidatorPipelineTest, ShortCircuit) {
+    PrefixValidator expensive("a");
+    PrefixValidator cheap("ab");
+    ValidatorPipeline pipeline;
+    pipeline.add(&expensive, 100).add(&cheap, 1);
+
+    EXPECT_TRUE(pipeline.validate(vector<string>(1, "abc")));
+    EXPECT_FALSE(pipeline.validate(vector<string>(1, "acb")));
+    EXPECT_FALSE(pipeline.validate(vector<string>(1, "bca")));
+    EXPECT_EQ(3, cheap.calls);
+    EXPECT_EQ(1, expensive.calls);
+
+    ValidatorPipeline::Stats stats = pipeline.getStats(0);
+    EXPECT_EQ(3u, stats.executions);
+    EXPECT_EQ(2u, stats.rejections);
+    EXPECT_DOUBLE_EQ(2.0 / 3.0, stats.getRejectionRate());
+    stats = pipeline.getStats(1);
+    EXPECT_EQ(1u, stats.executions);
+    EXPECT_EQ(0u, stats.rejections);
+    EXPECT_DOUBLE_EQ(0.0, stats.getRejectionRate());
+}
+
+TEST(ValidatorPipelineTest, Empty) {
+    ValidatorPipeline pipeline;
+    EXPECT_TRUE(pipeline.validate(vector<string>(1, "a")));
+    EXPECT_EQ(0u, pipeline.size());
+}